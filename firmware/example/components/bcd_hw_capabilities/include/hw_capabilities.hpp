@@ -12,6 +12,9 @@
 #ifdef CONFIG_DISPLAY_SUPPORT
 #include "gfx.hpp"
 #include "st7735_bcd.hpp"
+#ifdef CONFIG_LCD_BACKEND_ESP_LCD
+#include "bcd_esp_lcd.hpp"
+#endif // CONFIG_LCD_BACKEND_ESP_LCD
 #endif // CONFIG_DISPLAY_SUPPORT
 
 #include "ch405labs_esp_controller.hpp"
@@ -23,10 +26,11 @@
 // Display definitions
 #define LCD_WIDTH       CONFIG_LCD_WIDTH  // 128
 #define LCD_HEIGHT      CONFIG_LCD_HEIGHT // 160
-#define LCD_ROTATION    3
+#define LCD_ROTATION    CONFIG_LCD_ROTATION
 // A note on the SPI bufffer. If buffer is too small (eg. 1/5 of the display
-// size - TODO benchmarks needed), then its probably more efficient to disable
-// the copy_from (which leads to using batching instead of blt)
+// size - measure with the benchmark module, mod_benchmark), then its probably
+// more efficient to disable the copy_from (which leads to using batching
+// instead of blt)
 #if CONFIG_IDF_TARGET_ESP32S2 || CONFIG_IDF_TARGET_ESP32S3 || CONFIG_IDF_TARGET_ESP32C3
     #define SPI_BUFFER_SIZE      32768UL // As this is also the max transfer size on S3, TODO verify for S2,C3
 #elif CONFIG_IDF_TARGET_ESP32
@@ -58,6 +62,19 @@
 // memory. it usually works fine at default but you can change it for performance 
 // tuning. It's the final parameter: Note that it shouldn't be any bigger than 
 // the DMA size
+#ifdef CONFIG_LCD_BACKEND_ESP_LCD
+// Same panel on the esp_lcd panel IO. The buffer is split into two DMA
+// buffers, so one is filled while the other is sent.
+using lcd_type = bcd_render::esp_lcd_st7735<LCD_WIDTH,
+                        LCD_HEIGHT,
+                        LCD_HOST,
+                        PIN_NUM_CS,
+                        PIN_NUM_DC,
+                        PIN_NUM_RST,
+                        PIN_NUM_BCKL,
+                        LCD_ROTATION,
+                        SPI_BUFFER_SIZE>;
+#else // CONFIG_LCD_BACKEND_SPI_MASTER
 using lcd_type = espidf::st7735<LCD_WIDTH,
                         LCD_HEIGHT,
                         LCD_HOST,
@@ -67,6 +84,7 @@ using lcd_type = espidf::st7735<LCD_WIDTH,
                         PIN_NUM_BCKL,
                         LCD_ROTATION,
                         SPI_BUFFER_SIZE>;
+#endif // CONFIG_LCD_BACKEND_ESP_LCD
 
 using lcd_color = gfx::color<typename lcd_type::pixel_type>;
 #endif //CONFIG_DISPLAY_SUPPORT
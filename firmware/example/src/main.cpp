@@ -7,6 +7,15 @@
  ****************************************************************/
 Main App;
 
+// Shown by the logo slideshow, the next logo is decoded while one is shown
+static const char *const logos[] = {
+    "/spiffs/logo_2k13.jpeg", "/spiffs/logo_2k14.jpeg",
+    "/spiffs/logo_2k15.jpeg", "/spiffs/logo_2k16.jpeg",
+    "/spiffs/logo_2k17.jpeg", "/spiffs/logo_2k18.jpeg",
+    "/spiffs/logo_2k19.jpeg", "/spiffs/logo_2k20.jpeg",
+    "/spiffs/logo_2k22.jpeg", "/spiffs/logo_2k23.jpeg",
+};
+
 void Main::run(void) {
 #ifdef CONFIG_DEBUG_STACK
     UBaseType_t uxHighWaterMark;
@@ -16,6 +25,10 @@ void Main::run(void) {
     ESP_LOGD(TAG_STACK, "Main:run(): High watermark for stack at start is: %d", uxHighWaterMark);
 #endif
 
+    bcd_benchmark::configure(lcd, Bm437_Acer_VGA_8x8_FON,
+        "/spiffs/logo_2k23.jpeg");
+    bcd_slideshow::configure(logos, sizeof(logos) / sizeof(logos[0]));
+
    if(bcd_sys.consoleSupport()) {
 // <--- Register console commands below -->
         console.registerCommand("lsap", &lsap, "List available access points.");
@@ -33,6 +46,8 @@ void Main::run(void) {
         console.registerCommand("minheap", &heap_size, 
             "Get minimum size of free heap memory that was available during" 
             "programm execution.");
+        console.registerCommand("benchmark", &bcd_benchmark::command<lcd_type>,
+            "Measure fill, blit, text and JPEG throughput of the display.");
 #if WITH_TASKS_INFO
         console.registerCommand("tasks", &tasks_info, 
             "Get information about running tasks.");
@@ -80,29 +95,39 @@ void Main::run(void) {
 
 #ifdef CONFIG_DISPLAY_SUPPORT
     // Display conference logo for booting.
-    // First we need to open a file stream to the jpeg that contains
-    // the logo. (GFX currently only supports jpeg)
-    file_stream fs("/spiffs/logo_2k23.jpeg");
-    if(!fs.caps().read) {
-        ESP_LOGE(TAG_FS, "Failed to open logo. Not showing....");
-    } else {
-        // To display the image we need to call jpeg_image::load with a
-        // callback function that draws a portion of the image. We 
-        // specify this callback directly as an argument.
-        jpeg_image::load(&fs,[](size16 dimensions,
-                                typename jpeg_image::region_type& region,
-                                point16 location,
-                                void* state) {
-            // use draw:: to render this portion to the display
-            return draw::bitmap(bcd_sys.getDisplay(), 
-                                srect16((spoint16)location,
-                                        (ssize16)region.dimensions()),
-                                        region,region.bounds());
-        // we don't need state, so just use nullptr
-        },nullptr);
+    // The image cache decodes the logo once and keeps it in PSRAM, so
+    // showing it again is a single blit.
+    const bcd_render::image_cache::bitmap_type *logo;
+    if(imageCache.get("/spiffs/logo_2k23.jpeg", &logo) == RENDER_OK) {
+        draw::bitmap(lcd, (srect16)logo->bounds(), *logo, logo->bounds());
 
         // Display the logo for half a second before moving on
         vTaskDelay(pdMS_TO_TICKS(500));
+    } else {
+        // If it cannot be cached, we need to open a file stream to the jpeg
+        // that contains the logo. (GFX currently only supports jpeg)
+        file_stream fs("/spiffs/logo_2k23.jpeg");
+        if(!fs.caps().read) {
+            ESP_LOGE(TAG_FS, "Failed to open logo. Not showing....");
+        } else {
+            // To display the image we need to call jpeg_image::load with a
+            // callback function that draws a portion of the image. We 
+            // specify this callback directly as an argument.
+            jpeg_image::load(&fs,[](size16 dimensions,
+                                    typename jpeg_image::region_type& region,
+                                    point16 location,
+                                    void* state) {
+                // use draw:: to render this portion to the display
+                return draw::bitmap(bcd_sys.getDisplay(), 
+                                    srect16((spoint16)location,
+                                            (ssize16)region.dimensions()),
+                                            region,region.bounds());
+            // we don't need state, so just use nullptr
+            },nullptr);
+
+            // Display the logo for half a second before moving on
+            vTaskDelay(pdMS_TO_TICKS(500));
+        }
     }
 
 
@@ -138,10 +163,11 @@ void Main::run(void) {
         // Rest of main menu
         void *args[2] = {(void*)&lcd, (void*)&cmdTaskHandle};
         mc.cursor->addEntry(mc.createActionItem("Access Cyberspace", bcd_cyberspace::sshConnectFunction<lcd_type>, args));
-        mc.cursor->addEntry(mc.createActionItem("Logo Slideshow", logoSlideshow<lcd_type>, &lcd));
+        mc.cursor->addEntry(mc.createActionItem("Logo Slideshow", bcd_slideshow::module_main<lcd_type>, &lcd));
         mc.cursor->addEntry(mc.createActionItem("Party", discoFunction<lcd_type>, &lcd));
         mc.cursor->addEntry(mc.createActionItem("SAO Test", saoBlink<lcd_type>, &lcd));
         mc.cursor->addEntry(mc.createActionItem("Demo Mode", modDemoMode::demoMode<lcd_type>, &lcd));
+        mc.cursor->addEntry(mc.createActionItem("Benchmark", bcd_benchmark::module_main<lcd_type>, &lcd));
 
         // Settings Submenu
         mc.cursor->addEntry(mc.createSubmenu("Settings"));
@@ -157,20 +183,26 @@ void Main::run(void) {
         srect16 bounds = srect16(bmp->bounds());
         mc.cursor->drawMenu(*bmp, bounds, lcd_color::alice_blue, lcd_color::dark_goldenrod);
 
+        // Only rows that changed since the last push go to the display
+        bcd_render::row_diff menuRows;
+        menuRows.initialize(bmp_size.height);
+        menuRows.send(lcd, *bmp);
+
         // 2 Start the main loop. This loop must never exit!
         ESP_LOGV(TAG_STATE, "Starting main loop.");
         bounds = srect16(bmp->bounds());
         while(true) {
 
-            controller.capture();
+            // Sleeps until a button is pressed, nothing is drawn meanwhile
+            uint8_t input = waitForInput();
             
-            if(controller.getButtonState(BUTTON_DOWN)) {
+            if(input & MENU_INPUT_DOWN) {
                 mc.cursor->deselectEntry();
                 mc.cursor->next();
                 mc.cursor->selectEntry();
                 bounds = srect16(bmp->bounds());
                 mc.cursor->drawMenu(*bmp, bounds, lcd_color::alice_blue, lcd_color::dark_goldenrod);
-            } else if(controller.getButtonState(BUTTON_UP)) {
+            } else if(input & MENU_INPUT_UP) {
                 mc.cursor->deselectEntry();
                 mc.cursor->previous();
                 mc.cursor->selectEntry();
@@ -178,7 +210,7 @@ void Main::run(void) {
                 mc.cursor->drawMenu(*bmp, bounds, lcd_color::alice_blue, lcd_color::dark_goldenrod);
             } 
 
-            if(controller.getButtonState(BUTTON_A) || controller.getButtonState(BUTTON_B)) {
+            if(input & MENU_INPUT_ENTER) {
                 const Entry<bmp_type, bmp_type::pixel_type> *e = mc.cursor->getEntry();
                 if(e != NULL && typeid(*e) == typeid(ActionItem<bmp_type, bmp_type::pixel_type>)) {
                     int return_code = ((ActionItem<bmp_type, bmp_type::pixel_type> *)e)->execute();
@@ -188,6 +220,7 @@ void Main::run(void) {
                         ESP_LOGW(TAG_STATE,"Menu execution returned with code %d.", return_code);
                     };
                     // Need to draw menu again, as execution could have used screen
+                    menuRows.invalidate();
                     bounds = srect16(bmp->bounds());
                     mc.cursor->drawMenu(*bmp, bounds, lcd_color::alice_blue, lcd_color::dark_goldenrod);
                 } else if (e != NULL && typeid(*e) == typeid(Submenu<bmp_type, bmp_type::pixel_type>)) {
@@ -200,7 +233,7 @@ void Main::run(void) {
                 }
             }
 
-            if(controller.getButtonState(BUTTON_X) || controller.getButtonState(BUTTON_Y)) { 
+            if(input & MENU_INPUT_BACK) { 
                 // Only redraw if we are not in the main menu
                 mc.cursor->deselectEntry();
                 if(mc.cursor->leave() == GFXMENU_OK) {
@@ -208,8 +241,7 @@ void Main::run(void) {
                     mc.cursor->drawMenu(*bmp, bounds, lcd_color::alice_blue, lcd_color::dark_goldenrod);
                 }
             }
-            draw::bitmap(lcd, (srect16)lcd.bounds(), *bmp, bmp->bounds());
-            vTaskDelay(pdMS_TO_TICKS(150));
+            menuRows.send(lcd, *bmp);
         }
         delete bmp;
         free(bmp_buf);
@@ -238,6 +270,64 @@ ESP_LOGD(TAG_STACK, "Main:run(): High watermark for stack after after state exec
 #endif  
 }
 
+#ifdef CONFIG_CH405LABS_CONTROLLER_SUPPORT
+/**
+ * @brief Blocks until the menu has something to do
+ *
+ * The controller is a shift register without interrupt line, so waiting
+ * means sampling it. Sampling a few bits is cheap. Drawing is not, and the
+ * menu only draws after this returns. Only new presses count, except up
+ * and down, which repeat while held.
+ *
+ * Right after input the controller is sampled every MENU_POLL_MS, so
+ * repeats and quick follow-up presses are on time. With no button held the
+ * period doubles up to MENU_IDLE_POLL_MS, so an idle menu wakes up no more
+ * often than the old 150 ms redraw loop did.
+ *
+ * @return MENU_INPUT_* bits of the buttons to act on
+ */
+uint8_t Main::waitForInput(void) {
+    uint32_t poll = MENU_POLL_MS;
+    while(true) {
+        controller.capture();
+        uint8_t state = 0;
+        if(controller.getButtonState(BUTTON_UP)) {
+            state |= MENU_INPUT_UP;
+        }
+        if(controller.getButtonState(BUTTON_DOWN)) {
+            state |= MENU_INPUT_DOWN;
+        }
+        if(controller.getButtonState(BUTTON_A)
+                || controller.getButtonState(BUTTON_B)) {
+            state |= MENU_INPUT_ENTER;
+        }
+        if(controller.getButtonState(BUTTON_X)
+                || controller.getButtonState(BUTTON_Y)) {
+            state |= MENU_INPUT_BACK;
+        }
+
+        uint8_t pressed = state & ~menuInputState;
+        menuInputState = state;
+        TickType_t now = xTaskGetTickCount();
+        if(pressed != 0) {
+            menuRepeatAt = now + pdMS_TO_TICKS(MENU_REPEAT_DELAY_MS);
+            return pressed;
+        }
+        uint8_t held = state & (MENU_INPUT_UP | MENU_INPUT_DOWN);
+        if(held != 0 && (int32_t)(now - menuRepeatAt) >= 0) {
+            menuRepeatAt = now + pdMS_TO_TICKS(MENU_REPEAT_MS);
+            return held;
+        }
+        if(state != 0) {
+            poll = MENU_POLL_MS;
+        } else if(poll < MENU_IDLE_POLL_MS) {
+            poll = poll * 2 < MENU_IDLE_POLL_MS ? poll * 2 : MENU_IDLE_POLL_MS;
+        }
+        vTaskDelay(pdMS_TO_TICKS(poll));
+    }
+}
+#endif //CONFIG_CH405LABS_CONTROLLER_SUPPORT
+
 /**
  * @brief The setup function for the badge
  * 
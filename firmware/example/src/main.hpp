@@ -20,6 +20,8 @@
 #include "ch405labs_esp_debug.h"
 #ifdef CONFIG_DISPLAY_SUPPORT
 #include "ch405labs_gfx_menu.hpp"
+#include "bcd_image_cache.hpp"
+#include "bcd_row_diff.hpp"
 #include "../fonts/Bm437_Acer_VGA_8x8.h"
 #endif // CONFIG_DISPLAY_SUPPORT
 
@@ -29,11 +31,12 @@
 // Add includes for the modules you use here
 #include "mod_bcd_demo.hpp"
 #include "mod_party.hpp"
-#include "mod_logoslideshow.hpp"
+#include "mod_slideshow.hpp"
 #include "mod_saodemo.hpp"
 #include "mod_settings.hpp"
 #include "mod_snake.hpp"
 #include "mod_cyberspace.hpp"
+#include "mod_benchmark.hpp"
 
 // <----------------------------- Commands ------------------------------------>
 //
@@ -53,6 +56,17 @@ using namespace gfx;
 #define WIFI_PASS                           CONFIG_WIFI_PASSWORD                // Default access point password
 #define WIFI_MAXIMUM_RETRY                  CONFIG_WIFI_MAXIMUM_RETRY
 
+// Menu input
+#define MENU_POLL_MS                        20                                  // Controller sampling period after input
+#define MENU_IDLE_POLL_MS                   150                                 // Longest sampling period with no button held
+#define MENU_REPEAT_DELAY_MS                400                                 // Hold time before up/down repeat
+#define MENU_REPEAT_MS                      150                                 // Up/down repeat period
+
+#define MENU_INPUT_UP                       0x01
+#define MENU_INPUT_DOWN                     0x02
+#define MENU_INPUT_ENTER                    0x04                                // A or B
+#define MENU_INPUT_BACK                     0x08                                // X or Y
+
 
 // Globals
 static const char TAG_STATE[] = "State";
@@ -76,9 +90,13 @@ class Main final {
     private:
 #ifdef CONFIG_DISPLAY_SUPPORT
         lcd_type &lcd = bcd_sys.getDisplay();                                   /**< Display driver */
+        bcd_render::image_cache imageCache;                                     /**< Decoded logos */
 #endif //CONFIG_DISPLAY_SUPPORT
 #ifdef CONFIG_CH405LABS_CONTROLLER_SUPPORT
         controllerDriver& controller = bcd_sys.getControllerDriver();           /**< Controller driver */
+        uint8_t menuInputState = 0;                                             /**< MENU_INPUT_* bits held at last sample */
+        TickType_t menuRepeatAt = 0;                                            /**< Tick of the next up/down repeat */
+        uint8_t waitForInput(void);                                             /**< Blocks until a menu button is pressed */
 #endif //CONFIG_CH405LABS_CONTROLLER_SUPPORT
 #ifdef CONFIG_LED_IF_SUPPORT
         ledDriver& led = bcd_sys.getLedDriver();                                /**< LED driver */
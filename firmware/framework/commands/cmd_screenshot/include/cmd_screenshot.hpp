@@ -0,0 +1,88 @@
+/**
+ * @file    cmd_screenshot.hpp
+ * @brief   Console command to capture the framebuffer
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * The screenshot command sends the current content of an RGB565 framebuffer
+ * over the console UART as a single binary frame:
+ *
+ *  offset  size  content
+ *  0       4     magic "BCDS"
+ *  4       1     format version (1)
+ *  5       1     encoding (0 = raw, 1 = RLE)
+ *  6       2     width, little endian
+ *  8       2     height, little endian
+ *  10      4     payload length in bytes, little endian
+ *  14      n     payload
+ *  14 + n  4     CRC-32 (IEEE) of bytes 0 .. 13 + n, little endian
+ *
+ * Pixels are sent as they are stored in the framebuffer, high byte first, in
+ * screen orientation. A framebuffer kept in the panel's native orientation is
+ * turned the way the display driver turns it (see bcd_orientation.hpp), so
+ * captures look the same whichever way the frame was composed. The
+ * RLE payload is a sequence of packets, each starting with a control byte c:
+ * if bit 7 is set, the next pixel is repeated (c & 0x7f) + 1 times, otherwise
+ * c + 1 literal pixels follow.
+ *
+ * tools/screenshot.py finds the frame in the console output and writes a PNG.
+ */
+#pragma once
+
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Menuconfig options
+////////////////////////////////////////////////////////////////////////////////
+#define TAG_SCREENSHOT CONFIG_TAG_SCREENSHOT
+
+////////////////////////////////////////////////////////////////////////////////
+// Error handling
+////////////////////////////////////////////////////////////////////////////////
+typedef BaseType_t screenshot_err_t;
+
+#define SCREENSHOT_FAIL             -1                                          /**< Generic failure */
+#define SCREENSHOT_OK               0x000                                       /**< All good */
+#define SCREENSHOT_ERR_NO_SOURCE    0x101                                       /**< No framebuffer registered */
+#define SCREENSHOT_ERR_NO_MEM       0x102                                       /**< Could not allocate buffer */
+#define SCREENSHOT_ERR_UART         0x103                                       /**< Console UART not usable */
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Sets the framebuffer the screenshot command captures
+ *
+ * The framebuffer is read while the command runs. If it is drawn to at the
+ * same time, the capture may contain parts of two frames.
+ *
+ * @param pixels RGB565 pixels, row by row without padding. nullptr disables
+ *      the command.
+ * @param width Width in pixels, as stored
+ * @param height Height in pixels, as stored
+ * @param rotation Rotation the display driver applies to the framebuffer,
+ *      0 - 3. 0 if the framebuffer is in screen orientation.
+ */
+void screenshot_set_source(const uint8_t *pixels, uint16_t width,
+    uint16_t height, uint8_t rotation = 0);
+
+/**
+ * @brief Encodes the framebuffer into a screenshot frame
+ *
+ * @param rle Use run length encoding instead of raw pixels
+ * @param frame Set to the frame on success. Free with heap_caps_free().
+ * @param size Set to the size of the frame in bytes
+ * @return SCREENSHOT_OK on success, error code otherwise
+ */
+screenshot_err_t screenshot_capture(bool rle, uint8_t **frame, size_t *size);
+
+/**
+ * @brief Console command: screenshot [raw|rle]
+ */
+int screenshot(int argc, char **argv);
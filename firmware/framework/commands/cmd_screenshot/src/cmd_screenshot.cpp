@@ -0,0 +1,220 @@
+#include "../include/cmd_screenshot.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include "driver/uart.h"
+
+#define SCREENSHOT_HEADER_SIZE  14
+#define SCREENSHOT_CRC_SIZE     4
+#define SCREENSHOT_VERSION      1
+#define SCREENSHOT_RAW          0
+#define SCREENSHOT_RLE          1
+#define SCREENSHOT_MAX_PACKET   128
+
+static const uint8_t *sourcePixels = nullptr;
+static uint16_t sourceWidth = 0;
+static uint16_t sourceHeight = 0;
+static uint8_t sourceRotation = 0;
+
+void screenshot_set_source(const uint8_t *pixels, uint16_t width,
+        uint16_t height, uint8_t rotation) {
+    sourcePixels = pixels;
+    sourceWidth = width;
+    sourceHeight = height;
+    sourceRotation = rotation & 3;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xff;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v & 0xffff);
+    put16(p + 2, v >> 16);
+}
+
+static uint16_t pixelAt(const uint8_t *pixels, size_t i) {
+    return (pixels[2 * i] << 8) | pixels[2 * i + 1];
+}
+
+// PackBits style encoding on 16 bit pixels. Two equal pixels already start a
+// run, as a run packet (3 bytes) is never longer than a literal of two.
+static size_t encodeRle(const uint8_t *pixels, size_t count, uint8_t *out) {
+    uint8_t *o = out;
+    size_t i = 0;
+    while(i < count) {
+        size_t run = 1;
+        while(i + run < count && run < SCREENSHOT_MAX_PACKET
+                && pixelAt(pixels, i + run) == pixelAt(pixels, i)) {
+            run++;
+        }
+        if(run > 1) {
+            *o++ = 0x80 | (run - 1);
+            *o++ = pixels[2 * i];
+            *o++ = pixels[2 * i + 1];
+            i += run;
+            continue;
+        }
+
+        size_t literal = 1;
+        while(i + literal < count && literal < SCREENSHOT_MAX_PACKET
+                && (i + literal + 1 >= count || pixelAt(pixels, i + literal)
+                    != pixelAt(pixels, i + literal + 1))) {
+            literal++;
+        }
+        *o++ = literal - 1;
+        memcpy(o, pixels + 2 * i, 2 * literal);
+        o += 2 * literal;
+        i += literal;
+    }
+    return o - out;
+}
+
+// Copies the framebuffer into screen orientation. Same mapping as
+// bcd_render::orientation: rotation 1 turns the picture by 90 degrees
+// clockwise, every further step by another 90 degrees.
+static void unrotate(uint8_t *out) {
+    const uint16_t w = sourceRotation & 1 ? sourceHeight : sourceWidth;
+    const uint16_t h = sourceRotation & 1 ? sourceWidth : sourceHeight;
+    for(uint16_t y = 0; y < h; y++) {
+        for(uint16_t x = 0; x < w; x++) {
+            uint16_t nx = x;
+            uint16_t ny = y;
+            if(sourceRotation == 1) {
+                nx = sourceWidth - 1 - y;
+                ny = x;
+            } else if(sourceRotation == 2) {
+                nx = sourceWidth - 1 - x;
+                ny = sourceHeight - 1 - y;
+            } else if(sourceRotation == 3) {
+                nx = y;
+                ny = sourceHeight - 1 - x;
+            }
+            const uint8_t *p = sourcePixels
+                + 2 * ((size_t)ny * sourceWidth + nx);
+            *out++ = p[0];
+            *out++ = p[1];
+        }
+    }
+}
+
+screenshot_err_t screenshot_capture(bool rle, uint8_t **frame, size_t *size) {
+    if(sourcePixels == nullptr) {
+        return SCREENSHOT_ERR_NO_SOURCE;
+    }
+
+    size_t count = (size_t)sourceWidth * sourceHeight;
+    const uint16_t width = sourceRotation & 1 ? sourceHeight : sourceWidth;
+    const uint16_t height = sourceRotation & 1 ? sourceWidth : sourceHeight;
+    // Worst case for RLE is one control byte per 128 literal pixels
+    size_t maxPayload = 2 * count
+        + (rle ? (count + SCREENSHOT_MAX_PACKET - 1) / SCREENSHOT_MAX_PACKET
+            : 0);
+    size_t maxSize = SCREENSHOT_HEADER_SIZE + maxPayload + SCREENSHOT_CRC_SIZE;
+
+    uint8_t *buffer = (uint8_t *)heap_caps_malloc(maxSize, MALLOC_CAP_SPIRAM);
+    if(buffer == nullptr) {
+        buffer = (uint8_t *)heap_caps_malloc(maxSize, MALLOC_CAP_8BIT);
+    }
+    if(buffer == nullptr) {
+        ESP_LOGE(TAG_SCREENSHOT, "No memory for %u byte frame.",
+            (unsigned)maxSize);
+        return SCREENSHOT_ERR_NO_MEM;
+    }
+
+    uint8_t *payload = buffer + SCREENSHOT_HEADER_SIZE;
+    size_t payloadSize;
+    if(sourceRotation == 0) {
+        if(rle) {
+            payloadSize = encodeRle(sourcePixels, count, payload);
+        } else {
+            payloadSize = 2 * count;
+            memcpy(payload, sourcePixels, payloadSize);
+        }
+    } else if(!rle) {
+        payloadSize = 2 * count;
+        unrotate(payload);
+    } else {
+        // Runs are found along screen rows, so the pixels are turned into
+        // a staging buffer first
+        uint8_t *staging = (uint8_t *)heap_caps_malloc(2 * count,
+            MALLOC_CAP_SPIRAM);
+        if(staging == nullptr) {
+            staging = (uint8_t *)heap_caps_malloc(2 * count, MALLOC_CAP_8BIT);
+        }
+        if(staging == nullptr) {
+            ESP_LOGE(TAG_SCREENSHOT, "No memory for %u byte staging buffer.",
+                (unsigned)(2 * count));
+            heap_caps_free(buffer);
+            return SCREENSHOT_ERR_NO_MEM;
+        }
+        unrotate(staging);
+        payloadSize = encodeRle(staging, count, payload);
+        heap_caps_free(staging);
+    }
+
+    memcpy(buffer, "BCDS", 4);
+    buffer[4] = SCREENSHOT_VERSION;
+    buffer[5] = rle ? SCREENSHOT_RLE : SCREENSHOT_RAW;
+    put16(buffer + 6, width);
+    put16(buffer + 8, height);
+    put32(buffer + 10, payloadSize);
+    put32(payload + payloadSize, esp_rom_crc32_le(0, buffer,
+        SCREENSHOT_HEADER_SIZE + payloadSize));
+
+    *frame = buffer;
+    *size = SCREENSHOT_HEADER_SIZE + payloadSize + SCREENSHOT_CRC_SIZE;
+    return SCREENSHOT_OK;
+}
+
+int screenshot(int argc, char **argv) {
+#ifdef CONFIG_SCREENSHOT_RLE
+    bool rle = true;
+#else
+    bool rle = false;
+#endif
+    if(argc > 1) {
+        if(strcmp(argv[1], "raw") == 0) {
+            rle = false;
+        } else if(strcmp(argv[1], "rle") == 0) {
+            rle = true;
+        } else {
+            printf("Usage: %s [raw|rle]\n", argv[0]);
+            return SCREENSHOT_FAIL;
+        }
+    }
+
+    // The frame is written to the UART driver directly. Going through stdout
+    // would translate line endings inside the binary data.
+    if(!uart_is_driver_installed(CONFIG_ESP_CONSOLE_UART_NUM)) {
+        ESP_LOGE(TAG_SCREENSHOT, "Console UART driver not installed.");
+        return SCREENSHOT_ERR_UART;
+    }
+
+    uint8_t *frame;
+    size_t size;
+    screenshot_err_t err = screenshot_capture(rle, &frame, &size);
+    if(err == SCREENSHOT_ERR_NO_SOURCE) {
+        printf("No framebuffer to capture.\n");
+        return err;
+    } else if(err != SCREENSHOT_OK) {
+        return err;
+    }
+
+    fflush(stdout);
+    uart_wait_tx_done(CONFIG_ESP_CONSOLE_UART_NUM, portMAX_DELAY);
+    int written = uart_write_bytes(CONFIG_ESP_CONSOLE_UART_NUM, frame, size);
+    uart_wait_tx_done(CONFIG_ESP_CONSOLE_UART_NUM, portMAX_DELAY);
+    heap_caps_free(frame);
+
+    if(written != (int)size) {
+        ESP_LOGE(TAG_SCREENSHOT, "UART write failed.");
+        return SCREENSHOT_ERR_UART;
+    }
+    printf("\nScreenshot: %u bytes\n", (unsigned)size);
+    return SCREENSHOT_OK;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file    bcd_assets.hpp
+ * @brief   Memory mapped asset partition
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Images on SPIFFS have to be looked up in the file system, read and decoded
+ * every time they are shown. tools/asset_compiler.py converts them at build
+ * time into panel-ready RGB565 and packs them into a raw data partition with
+ * an index. The asset partition maps that partition into the address space
+ * with esp_partition_mmap(), so an uncompressed image can be blitted straight
+ * from flash, without a copy and without decoding.
+ *
+ * The layout of the partition is documented in tools/asset_compiler.py.
+ *
+ * Usage:
+ *      bcd_assets::asset_partition assets;
+ *      assets.initialize();
+ *      bcd_assets::asset a;
+ *      if(assets.find("start_screen", &a) == ASSETS_OK
+ *              && a.format == bcd_assets::format_e::RGB565) {
+ *          draw::bitmap(lcd, srect16(spoint16(0, 0), (ssize16)a.dimensions),
+ *              a.bitmap(), rect16(point16(0, 0), a.dimensions));
+ *      }
+ */
+#pragma once
+
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "gfx.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Menuconfig options
+////////////////////////////////////////////////////////////////////////////////
+#define TAG_ASSETS CONFIG_TAG_ASSETS
+
+////////////////////////////////////////////////////////////////////////////////
+// Error handling
+////////////////////////////////////////////////////////////////////////////////
+typedef BaseType_t assets_err_t;
+
+#define ASSETS_FAIL                 -1                                          /**< Generic failure */
+#define ASSETS_OK                   0x000                                       /**< All good */
+#define ASSETS_ERR_NO_PARTITION     0x101                                       /**< Asset partition not found */
+#define ASSETS_ERR_INVALID          0x102                                       /**< Partition holds no valid asset image */
+#define ASSETS_ERR_NOT_FOUND        0x103                                       /**< No asset with this name */
+#define ASSETS_ERR_FORMAT           0x104                                       /**< Asset has the wrong format */
+#define ASSETS_ERR_NOT_INITIALIZED  0x105                                       /**< Partition not mapped */
+
+namespace bcd_assets {
+
+enum class format_e : uint8_t {
+    RAW = 0,                                                                    /**< Bytes as in the source file */
+    RGB565 = 1,                                                                 /**< Pixels, high byte first */
+    RGB565_RLE = 2,                                                             /**< Run length encoded pixels */
+};
+
+struct asset {
+    using bitmap_type = gfx::const_bitmap<gfx::rgb_pixel<16>>;
+
+    format_e format;
+    gfx::size16 dimensions;                                                     /**< Size of images, 0x0 for RAW */
+    const uint8_t *data;                                                        /**< Mapped contents */
+    size_t length;                                                              /**< Bytes at data */
+
+    /**
+     * @brief Returns the pixels of an RGB565 asset, mapped from flash
+     */
+    bitmap_type bitmap() const { return bitmap_type(dimensions, data); }
+};
+
+class asset_partition {
+    public:
+        asset_partition() = default;
+        asset_partition(const asset_partition &) = delete;
+        asset_partition &operator=(const asset_partition &) = delete;
+        ~asset_partition() { deinitialize(); }
+
+        /**
+         * @brief Maps the asset partition and checks its header
+         *
+         * @param label Label of the partition
+         * @return ASSETS_OK on success, ASSETS_ERR_NO_PARTITION if there is
+         *      no such partition, ASSETS_ERR_INVALID if it was not written
+         *      by asset_compiler.py and ASSETS_FAIL if mapping failed.
+         */
+        assets_err_t initialize(
+            const char *label = CONFIG_ASSETS_PARTITION_LABEL);
+        void deinitialize();
+        bool initialized() const { return base != nullptr; }
+
+        /**
+         * @brief Looks up an asset by name
+         *
+         * @return ASSETS_OK on success, ASSETS_ERR_NOT_FOUND if there is no
+         *      asset with this name.
+         */
+        assets_err_t find(const char *name, asset *out) const;
+
+        /**
+         * @brief Decompresses a RGB565_RLE asset
+         *
+         * @param a The asset
+         * @param out Receives dimensions.width * dimensions.height pixels
+         * @param size Size of out in bytes
+         * @return ASSETS_OK on success, ASSETS_ERR_FORMAT if the asset is not
+         *      RGB565_RLE or out is too small, ASSETS_ERR_INVALID if the data
+         *      is corrupt.
+         */
+        static assets_err_t decompress(const asset &a, uint8_t *out,
+            size_t size);
+
+        size_t count() const;
+
+    private:
+        const uint8_t *base = nullptr;
+        size_t mapped = 0;
+        esp_partition_mmap_handle_t handle;
+};
+
+} // namespace bcd_assets
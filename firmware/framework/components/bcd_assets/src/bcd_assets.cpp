@@ -0,0 +1,153 @@
+#include "../include/bcd_assets.hpp"
+#include <string.h>
+
+namespace bcd_assets {
+
+// Layout written by tools/asset_compiler.py
+struct header_t {
+    char magic[4];
+    uint16_t version;
+    uint16_t count;
+    uint32_t size;
+};
+
+struct entry_t {
+    char name[24];
+    uint8_t format;
+    uint8_t reserved;
+    uint16_t width;
+    uint16_t height;
+    uint16_t reserved2;
+    uint32_t offset;
+    uint32_t length;
+};
+
+static_assert(sizeof(header_t) == 12, "Header must match asset_compiler.py");
+static_assert(sizeof(entry_t) == 40, "Entry must match asset_compiler.py");
+
+static const char MAGIC[4] = { 'B', 'C', 'D', 'A' };
+static const uint16_t VERSION = 1;
+
+assets_err_t asset_partition::initialize(const char *label) {
+    if(base != nullptr) {
+        return ASSETS_OK;
+    }
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if(partition == nullptr) {
+        ESP_LOGW(TAG_ASSETS, "No partition %s.", label);
+        return ASSETS_ERR_NO_PARTITION;
+    }
+
+    // Check the header before mapping, so only the used part is mapped
+    header_t header;
+    if(esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK
+            || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+            || header.version != VERSION
+            || header.size > partition->size
+            || header.size < sizeof(header_t)
+                + header.count * sizeof(entry_t)) {
+        ESP_LOGW(TAG_ASSETS, "Partition %s holds no assets. Flash the "
+            "output of tools/asset_compiler.py.", label);
+        return ASSETS_ERR_INVALID;
+    }
+
+    const void *ptr;
+    esp_err_t err = esp_partition_mmap(partition, 0, header.size,
+        ESP_PARTITION_MMAP_DATA, &ptr, &handle);
+    if(err != ESP_OK) {
+        ESP_LOGE(TAG_ASSETS, "Could not map partition %s: %s", label,
+            esp_err_to_name(err));
+        return ASSETS_FAIL;
+    }
+    base = (const uint8_t *)ptr;
+    mapped = header.size;
+    ESP_LOGI(TAG_ASSETS, "Mapped %u assets, %u bytes.", header.count,
+        (unsigned)header.size);
+    return ASSETS_OK;
+}
+
+void asset_partition::deinitialize() {
+    if(base != nullptr) {
+        esp_partition_munmap(handle);
+        base = nullptr;
+        mapped = 0;
+    }
+}
+
+size_t asset_partition::count() const {
+    return base != nullptr ? ((const header_t *)base)->count : 0;
+}
+
+assets_err_t asset_partition::find(const char *name, asset *out) const {
+    if(base == nullptr) {
+        return ASSETS_ERR_NOT_INITIALIZED;
+    }
+    // The compiler sorts the entries by name
+    const entry_t *entries = (const entry_t *)(base + sizeof(header_t));
+    size_t lo = 0;
+    size_t hi = count();
+    while(lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        const entry_t &e = entries[mid];
+        int cmp = strncmp(name, e.name, sizeof(e.name));
+        if(cmp == 0) {
+            if(e.offset + e.length > mapped) {
+                ESP_LOGE(TAG_ASSETS, "Asset %s is truncated.", name);
+                return ASSETS_ERR_INVALID;
+            }
+            out->format = (format_e)e.format;
+            out->dimensions = gfx::size16(e.width, e.height);
+            out->data = base + e.offset;
+            out->length = e.length;
+            return ASSETS_OK;
+        }
+        if(cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return ASSETS_ERR_NOT_FOUND;
+}
+
+assets_err_t asset_partition::decompress(const asset &a, uint8_t *out,
+        size_t size) {
+    size_t pixels = a.dimensions.width * a.dimensions.height;
+    if(a.format != format_e::RGB565_RLE || size < pixels * 2) {
+        return ASSETS_ERR_FORMAT;
+    }
+    // Same packets as the screenshot command: the high bit marks a run of
+    // one pixel, otherwise literal pixels follow
+    const uint8_t *in = a.data;
+    const uint8_t *end = a.data + a.length;
+    uint8_t *o = out;
+    uint8_t *oend = out + pixels * 2;
+    while(in < end) {
+        uint8_t c = *in++;
+        size_t n = (c & 0x7f) + 1;
+        if(o + n * 2 > oend) {
+            return ASSETS_ERR_INVALID;
+        }
+        if(c & 0x80) {
+            if(in + 2 > end) {
+                return ASSETS_ERR_INVALID;
+            }
+            for(size_t i = 0; i < n; i++) {
+                *o++ = in[0];
+                *o++ = in[1];
+            }
+            in += 2;
+        } else {
+            if(in + n * 2 > end) {
+                return ASSETS_ERR_INVALID;
+            }
+            memcpy(o, in, n * 2);
+            o += n * 2;
+            in += n * 2;
+        }
+    }
+    return o == oend ? ASSETS_OK : ASSETS_ERR_INVALID;
+}
+
+} // namespace bcd_assets
@@ -0,0 +1,355 @@
+/**
+ * @file    bcd_blit.hpp
+ * @brief   Fills and blits that pick the fastest kernel for their targets
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * bcd_render::fill() and bcd_render::blit() take the same arguments as
+ * gfx::draw::filled_rectangle() and gfx::draw::bitmap(). Which code runs is
+ * decided at compile time from the types involved: fills of an RGB565 bitmap
+ * and blits between RGB565 bitmaps use the kernels of bcd_rgb565.hpp, all
+ * other combinations, like drawing to the display, go to gfx.
+ *
+ * bcd_render::blend() lays a translucent colour over an area. It needs to
+ * read what is below, so only RGB565 bitmaps blend. Other targets, like the
+ * display itself, get an opaque fill instead. blend_mask() lays a colour
+ * over an area through an alpha mask, like an anti-aliased glyph. Targets
+ * that cannot be read back get the pixels of the mask that are at least
+ * half opaque.
+ *
+ * A blit only takes the fast path if it is not flipped or resized, gfx
+ * handles those. Both paths clip the same way.
+ *
+ * Views of a bitmap in native panel orientation (see bcd_orientation.hpp)
+ * take the fast paths as well. Fills and blends are mapped to the native
+ * rectangle, blits step through the native memory along the layout's rows.
+ *
+ * Support for another pair of types is added by specialising fill_kernel,
+ * blit_kernel, blend_kernel or mask_kernel.
+ *
+ * Usage:
+ *      bmp_type frame(size16(128, 160), buffer);
+ *      bcd_render::fill(frame, srect16(0, 0, 127, 15),
+ *          color<pixel_type>::black);
+ *      bcd_render::blit(frame, srect16(10, 10, 41, 41), tile, tile.bounds());
+ *      bcd_render::blend(frame, srect16(0, 0, 127, 159),
+ *          color<pixel_type>::black, 128);
+ */
+#pragma once
+
+#include <stdint.h>
+#include "gfx.hpp"
+#include "bcd_rgb565.hpp"
+#include "bcd_orientation.hpp"
+
+namespace bcd_render {
+
+using rgb565_bitmap = gfx::bitmap<gfx::rgb_pixel<16>>;
+using rgb565_const_bitmap = gfx::const_bitmap<gfx::rgb_pixel<16>>;
+
+/**
+ * @brief Fills through gfx. Specialised for targets with a faster way.
+ */
+template<typename Destination>
+struct fill_kernel {
+    static gfx::gfx_result fill(Destination &destination,
+            const gfx::srect16 &r,
+            typename Destination::pixel_type color) {
+        return gfx::draw::filled_rectangle(destination, r, color);
+    }
+};
+
+template<>
+struct fill_kernel<rgb565_bitmap> {
+    static gfx::gfx_result fill(rgb565_bitmap &destination,
+            const gfx::srect16 &r, gfx::rgb_pixel<16> color) {
+        const gfx::srect16 screen = (gfx::srect16)destination.bounds();
+        const gfx::srect16 n = r.normalize();
+        if(!screen.intersects(n)) {
+            return gfx::gfx_result::success;
+        }
+        const gfx::srect16 c = n.crop(screen);
+        rgb565::fill(destination.begin(), destination.dimensions().width * 2,
+            c.left(), c.top(), c.width(), c.height(), color.native_value);
+        return gfx::gfx_result::success;
+    }
+};
+
+template<uint8_t Rotation>
+struct fill_kernel<rotated_view<rgb565_bitmap, Rotation>> {
+    static gfx::gfx_result fill(rotated_view<rgb565_bitmap, Rotation> &view,
+            const gfx::srect16 &r, gfx::rgb_pixel<16> color) {
+        return fill_kernel<rgb565_bitmap>::fill(view.native(),
+            orientation<Rotation>::rect(r, view.native().dimensions()),
+            color);
+    }
+};
+
+/**
+ * @brief Fills opaquely. Specialised for targets that can be read back.
+ */
+template<typename Destination>
+struct blend_kernel {
+    static gfx::gfx_result blend(Destination &destination,
+            const gfx::srect16 &r, typename Destination::pixel_type color,
+            uint8_t alpha) {
+        return gfx::draw::filled_rectangle(destination, r, color);
+    }
+};
+
+template<>
+struct blend_kernel<rgb565_bitmap> {
+    static gfx::gfx_result blend(rgb565_bitmap &destination,
+            const gfx::srect16 &r, gfx::rgb_pixel<16> color, uint8_t alpha) {
+        const gfx::srect16 screen = (gfx::srect16)destination.bounds();
+        const gfx::srect16 n = r.normalize();
+        if(!screen.intersects(n)) {
+            return gfx::gfx_result::success;
+        }
+        const gfx::srect16 c = n.crop(screen);
+        rgb565::blend(destination.begin(), destination.dimensions().width * 2,
+            c.left(), c.top(), c.width(), c.height(), color.native_value,
+            alpha);
+        return gfx::gfx_result::success;
+    }
+};
+
+template<uint8_t Rotation>
+struct blend_kernel<rotated_view<rgb565_bitmap, Rotation>> {
+    static gfx::gfx_result blend(rotated_view<rgb565_bitmap, Rotation> &view,
+            const gfx::srect16 &r, gfx::rgb_pixel<16> color, uint8_t alpha) {
+        return blend_kernel<rgb565_bitmap>::blend(view.native(),
+            orientation<Rotation>::rect(r, view.native().dimensions()),
+            color, alpha);
+    }
+};
+
+/**
+ * @brief Blits through gfx. Specialised for pairs of types with a faster
+ *      way.
+ */
+template<typename Destination, typename Source>
+struct blit_kernel {
+    static gfx::gfx_result blit(Destination &destination,
+            const gfx::srect16 &r, const Source &source,
+            const gfx::rect16 &sourceRect) {
+        return gfx::draw::bitmap(destination, r, source, sourceRect);
+    }
+};
+
+/**
+ * @brief Where the pixels of an RGB565 bitmap are
+ *
+ * Specialised for views whose rows do not run along memory.
+ */
+template<typename Target>
+struct rgb565_layout {
+    /** Rows are contiguous in memory */
+    static constexpr bool rows = true;
+
+    static auto address(const Target &t, uint16_t x, uint16_t y) {
+        return t.begin() + (y * t.dimensions().width + x) * 2;
+    }
+    static ptrdiff_t stepX(const Target &) { return 2; }
+    static ptrdiff_t stepY(const Target &t) {
+        return t.dimensions().width * 2;
+    }
+};
+
+template<typename Bitmap, uint8_t Rotation>
+struct rgb565_layout<rotated_view<Bitmap, Rotation>> {
+    using transform = orientation<Rotation>;
+    static constexpr bool rows = Rotation == 0;
+
+    static auto address(const rotated_view<Bitmap, Rotation> &t, uint16_t x,
+            uint16_t y) {
+        const gfx::size16 native = t.native().dimensions();
+        const gfx::spoint16 p = transform::point(gfx::spoint16(x, y), native);
+        return t.native().begin() + (p.y * native.width + p.x) * 2;
+    }
+    static ptrdiff_t stepX(const rotated_view<Bitmap, Rotation> &t) {
+        return transform::stepX(t.native().dimensions().width * 2, 2);
+    }
+    static ptrdiff_t stepY(const rotated_view<Bitmap, Rotation> &t) {
+        return transform::stepY(t.native().dimensions().width * 2, 2);
+    }
+};
+
+/**
+ * @brief Row copies between RGB565 bitmaps, or pixel steps if one of them
+ *      is a rotated view
+ */
+template<typename Destination, typename Source>
+struct rgb565_blit_kernel {
+    static gfx::gfx_result blit(Destination &destination,
+            const gfx::srect16 &r, const Source &source,
+            const gfx::rect16 &sourceRect) {
+        // Flipped and resized blits are left to gfx
+        if(r.x1 > r.x2 || r.y1 > r.y2 || sourceRect.x1 > sourceRect.x2
+                || sourceRect.y1 > sourceRect.y2
+                || r.width() != sourceRect.width()
+                || r.height() != sourceRect.height()) {
+            return gfx::draw::bitmap(destination, r, source, sourceRect);
+        }
+
+        // Clip the source to its bitmap, then the destination to the
+        // screen, moving the other rectangle along
+        const gfx::rect16 sb = source.bounds();
+        if(!sb.intersects(sourceRect)) {
+            return gfx::gfx_result::success;
+        }
+        const gfx::rect16 s = sourceRect.crop(sb);
+        const gfx::srect16 d = gfx::srect16(
+            r.x1 + (s.x1 - sourceRect.x1), r.y1 + (s.y1 - sourceRect.y1),
+            r.x1 + (s.x2 - sourceRect.x1), r.y1 + (s.y2 - sourceRect.y1));
+        const gfx::srect16 screen = (gfx::srect16)destination.bounds();
+        if(!screen.intersects(d)) {
+            return gfx::gfx_result::success;
+        }
+        const gfx::srect16 c = d.crop(screen);
+        const uint16_t sx = s.x1 + (c.x1 - d.x1);
+        const uint16_t sy = s.y1 + (c.y1 - d.y1);
+
+        using dst = rgb565_layout<Destination>;
+        using src = rgb565_layout<Source>;
+        if constexpr(dst::rows && src::rows) {
+            rgb565::copy(dst::address(destination, c.x1, c.y1),
+                dst::stepY(destination), src::address(source, sx, sy),
+                src::stepY(source), c.width(), c.height());
+        } else {
+            rgb565::copy_strided(dst::address(destination, c.x1, c.y1),
+                dst::stepX(destination), dst::stepY(destination),
+                src::address(source, sx, sy), src::stepX(source),
+                src::stepY(source), c.width(), c.height());
+        }
+        return gfx::gfx_result::success;
+    }
+};
+
+template<>
+struct blit_kernel<rgb565_bitmap, rgb565_bitmap>
+    : rgb565_blit_kernel<rgb565_bitmap, rgb565_bitmap> {};
+
+template<>
+struct blit_kernel<rgb565_bitmap, rgb565_const_bitmap>
+    : rgb565_blit_kernel<rgb565_bitmap, rgb565_const_bitmap> {};
+
+template<uint8_t Rotation>
+struct blit_kernel<rotated_view<rgb565_bitmap, Rotation>, rgb565_bitmap>
+    : rgb565_blit_kernel<rotated_view<rgb565_bitmap, Rotation>,
+        rgb565_bitmap> {};
+
+template<uint8_t Rotation>
+struct blit_kernel<rotated_view<rgb565_bitmap, Rotation>,
+        rgb565_const_bitmap>
+    : rgb565_blit_kernel<rotated_view<rgb565_bitmap, Rotation>,
+        rgb565_const_bitmap> {};
+
+template<uint8_t Rotation>
+struct blit_kernel<rgb565_bitmap, rotated_view<rgb565_bitmap, Rotation>>
+    : rgb565_blit_kernel<rgb565_bitmap,
+        rotated_view<rgb565_bitmap, Rotation>> {};
+
+/**
+ * @brief Draws the mostly opaque pixels of a mask. Specialised for targets
+ *      that can be read back.
+ */
+template<typename Destination>
+struct mask_kernel {
+    static gfx::gfx_result blend(Destination &destination,
+            const gfx::srect16 &r, const uint8_t *mask, size_t maskStride,
+            typename Destination::pixel_type color) {
+        for(int16_t y = r.top(); y <= r.bottom(); y++, mask += maskStride) {
+            for(int16_t x = r.left(); x <= r.right(); x++) {
+                if(mask[x - r.left()] >= 128) {
+                    gfx::gfx_result res = gfx::draw::point(destination,
+                        gfx::spoint16(x, y), color);
+                    if(res != gfx::gfx_result::success) {
+                        return res;
+                    }
+                }
+            }
+        }
+        return gfx::gfx_result::success;
+    }
+};
+
+/**
+ * @brief Mask blends into RGB565 bitmaps and their rotated views
+ */
+template<typename Destination>
+struct rgb565_mask_kernel {
+    static gfx::gfx_result blend(Destination &destination,
+            const gfx::srect16 &r, const uint8_t *mask, size_t maskStride,
+            gfx::rgb_pixel<16> color) {
+        const gfx::srect16 screen = (gfx::srect16)destination.bounds();
+        if(r.x1 > r.x2 || r.y1 > r.y2 || !screen.intersects(r)) {
+            return gfx::gfx_result::success;
+        }
+        const gfx::srect16 c = r.crop(screen);
+        using dst = rgb565_layout<Destination>;
+        rgb565::blend_mask(dst::address(destination, c.x1, c.y1),
+            dst::stepX(destination), dst::stepY(destination),
+            mask + (c.y1 - r.y1) * maskStride + (c.x1 - r.x1), maskStride,
+            c.width(), c.height(), color.native_value);
+        return gfx::gfx_result::success;
+    }
+};
+
+template<>
+struct mask_kernel<rgb565_bitmap> : rgb565_mask_kernel<rgb565_bitmap> {};
+
+template<uint8_t Rotation>
+struct mask_kernel<rotated_view<rgb565_bitmap, Rotation>>
+    : rgb565_mask_kernel<rotated_view<rgb565_bitmap, Rotation>> {};
+
+/**
+ * @brief Fills a rectangle, like gfx::draw::filled_rectangle()
+ */
+template<typename Destination>
+gfx::gfx_result fill(Destination &destination, const gfx::srect16 &r,
+        typename Destination::pixel_type color) {
+    return fill_kernel<Destination>::fill(destination, r, color);
+}
+
+/**
+ * @brief Lays a translucent colour over a rectangle
+ *
+ * @param alpha Opacity of the colour, 0 (invisible) to 255 (opaque)
+ */
+template<typename Destination>
+gfx::gfx_result blend(Destination &destination, const gfx::srect16 &r,
+        typename Destination::pixel_type color, uint8_t alpha) {
+    return blend_kernel<Destination>::blend(destination, r, color, alpha);
+}
+
+/**
+ * @brief Lays a colour over a rectangle through an 8 bit alpha mask
+ *
+ * @param r The rectangle, the size of the mask. Not flipped.
+ * @param mask Alpha of the top left pixel, 0 (transparent) to 255 (opaque)
+ * @param maskStride Bytes per row of the mask
+ */
+template<typename Destination>
+gfx::gfx_result blend_mask(Destination &destination, const gfx::srect16 &r,
+        const uint8_t *mask, size_t maskStride,
+        typename Destination::pixel_type color) {
+    return mask_kernel<Destination>::blend(destination, r, mask, maskStride,
+        color);
+}
+
+/**
+ * @brief Draws part of a bitmap, like gfx::draw::bitmap()
+ *
+ * Source and destination must not be the same bitmap.
+ */
+template<typename Destination, typename Source>
+gfx::gfx_result blit(Destination &destination, const gfx::srect16 &r,
+        const Source &source, const gfx::rect16 &sourceRect) {
+    return blit_kernel<Destination, Source>::blit(destination, r, source,
+        sourceRect);
+}
+
+} // namespace bcd_render
@@ -0,0 +1,62 @@
+/**
+ * @file    bcd_dirty_rects.hpp
+ * @brief   Bounded set of dirty screen areas
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Collects the areas of the screen that changed during a frame and merges
+ * them into as few rectangles as makes sense for the display bus. Every
+ * rectangle that is sent to the panel costs an address window setup, so two
+ * areas are merged whenever sending their bounding box is cheaper than
+ * sending both on their own (see CONFIG_RENDER_WINDOW_COST_PX).
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bcd_render.hpp"
+#include "gfx_positioning.hpp"
+
+namespace bcd_render {
+
+class dirty_rects {
+    public:
+        static constexpr size_t capacity = CONFIG_RENDER_DIRTY_RECTS;
+
+        /**
+         * @brief Marks an area as dirty
+         *
+         * If the set is full, the area is merged into the rectangle where
+         * this causes the least overdraw.
+         *
+         * @param r The area that changed
+         */
+        void add(const gfx::rect16 &r);
+
+        /**
+         * @brief Merges rectangles until no merge saves bus time anymore
+         */
+        void coalesce();
+
+        void clear() { count = 0; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const gfx::rect16 &operator[](size_t i) const { return rects[i]; }
+
+        /**
+         * @brief Number of pixels covered by all rectangles
+         */
+        uint32_t pixels() const;
+
+    private:
+        gfx::rect16 rects[capacity];
+        size_t count = 0;
+
+        static uint32_t area(const gfx::rect16 &r);
+        static gfx::rect16 unite(const gfx::rect16 &a, const gfx::rect16 &b);
+        static int32_t mergeCost(const gfx::rect16 &a, const gfx::rect16 &b);
+};
+
+} // namespace bcd_render
@@ -0,0 +1,1120 @@
+/**
+ * @file    bcd_display_list.hpp
+ * @brief   Per frame display command list
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Drawing directly on the display turns every primitive into its own address
+ * window and SPI transaction. The display list records the primitives of a
+ * frame instead. On flush() they are rasterised into a shadow framebuffer,
+ * the touched areas are coalesced (see bcd_dirty_rects.hpp) and only the
+ * resulting rectangles are sent to the display, each as one address window
+ * with a contiguous pixel stream.
+ *
+ * If the shadow framebuffer cannot be allocated, the list falls back to
+ * drawing every primitive directly on the display when it is recorded.
+ *
+ * Text with a background colour is drawn from a glyph cache (see
+ * bcd_glyph_cache.hpp) once one is set with use_glyph_cache(), so it costs
+ * a few row copies per glyph instead of unpacking the font bits. Text in a
+ * TrueType font is drawn from a glyph atlas (see bcd_glyph_atlas.hpp),
+ * anti-aliased over what is already in the shadow framebuffer.
+ *
+ * Fills and bitmaps are rasterised into the shadow framebuffer with the word
+ * wide kernels of bcd_blit.hpp. blend() lays translucent rectangles over
+ * what is already there, eg. to dim the screen behind a dialog.
+ *
+ * Drawing that has no primitive, like composing a whole screen, goes through
+ * compose(). It draws into the shadow framebuffer and marks the area dirty.
+ * Scattered single pixels, like particles, are set with points(), which
+ * only marks the pixels themselves dirty.
+ *
+ * scroll() moves a part of the screen down. If the panel orientation allows
+ * it, this is done with the vertical scroll registers of the controller:
+ * the scrolled lines are not sent again, instead the list remembers the
+ * scroll offset and maps later writes into the scrolled band accordingly.
+ *
+ * Rotation is the rotation the driver applies to the screen. The list keeps
+ * its shadow framebuffer in the panel's native orientation and maps the
+ * screen coordinates of its primitives at compile time (see
+ * bcd_orientation.hpp). A flush switches the controller to its native scan
+ * order, writes the changed areas straight from the shadow as they are in
+ * memory and switches it back. Everything else keeps drawing through the
+ * driver in screen coordinates. With a rotation of 0 (the default) the
+ * shadow and the screen are the same and the driver sends the areas.
+ *
+ * enable_rgb444() marks an area whose colours survive the panel's 12 bit
+ * interface mode, like the playfield with its handful of colours. Changes
+ * inside it are sent as RGB444 (see panel_io::write_rgb444()), a quarter
+ * fewer bytes than RGB565, everything else and the whole screen after
+ * disable_rgb444() goes out in 16 bit. The shadow framebuffer stays RGB565.
+ *
+ * Usage:
+ *      bcd_render::display_list<lcd_type, CONFIG_RENDER_DISPLAY_LIST_SIZE,
+ *          LCD_ROTATION> dl(lcd);
+ *      dl.initialize();
+ *      dl.filled_rectangle(rect16(0, 0, 9, 9), color<pixel_type>::red);
+ *      dl.text(text_rect, "Score", font, color<pixel_type>::white);
+ *      dl.flush();
+ */
+#pragma once
+
+#include <string.h>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include "esp_heap_caps.h"
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+#include "bcd_dirty_rects.hpp"
+#include "bcd_panel.hpp"
+#include "bcd_indexed_surface.hpp"
+#include "bcd_glyph_cache.hpp"
+#include "bcd_glyph_atlas.hpp"
+#include "bcd_blit.hpp"
+#include "bcd_orientation.hpp"
+
+namespace bcd_render {
+
+/**
+ * @brief Statistics of the last flush, or of all flushes summed up
+ */
+struct display_list_stats {
+    uint32_t sequence = 0;                                                      /**< Number of the flush */
+    uint32_t primitives = 0;                                                    /**< Primitives rasterised */
+    uint32_t windows = 0;                                                       /**< Address windows sent */
+    uint32_t pixels = 0;                                                        /**< Pixels sent */
+    uint32_t scrolls = 0;                                                       /**< Hardware scroll updates */
+    uint32_t packed = 0;                                                        /**< Pixels sent as RGB444 */
+};
+
+template<typename Destination,
+        size_t Capacity = CONFIG_RENDER_DISPLAY_LIST_SIZE,
+        uint8_t Rotation = 0>
+class display_list {
+    public:
+        using pixel_type = typename Destination::pixel_type;
+        using bitmap_type = gfx::bitmap<pixel_type>;
+        using const_bitmap_type = gfx::const_bitmap<pixel_type>;
+        using transform = orientation<Rotation>;
+        /** The shadow framebuffer in screen coordinates */
+        using surface_type = typename std::conditional<Rotation == 0,
+            bitmap_type, rotated_view<bitmap_type, Rotation>>::type;
+
+        static_assert(Rotation == 0 || pixel_type::bit_depth == 16,
+            "Rotated shadow framebuffers are RGB565");
+
+        display_list(Destination &destination) : destination(destination) {}
+        display_list(const display_list &) = delete;
+        display_list &operator=(const display_list &) = delete;
+        ~display_list() { deinitialize(); }
+
+        /**
+         * @brief Allocates the shadow framebuffer
+         *
+         * The shadow framebuffer is cleared. The display is expected to be
+         * cleared as well (or to be cleared through the list before the
+         * first flush).
+         *
+         * @return RENDER_OK on success, RENDER_ERR_NO_MEM if the list has to
+         *      work in immediate mode.
+         */
+        render_err_t initialize() {
+            if(shadow != nullptr) {
+                return RENDER_OK;
+            }
+            const gfx::size16 native = transform::layout(
+                destination.dimensions());
+            size_t size = bitmap_type::sizeof_buffer(native);
+#ifdef CONFIG_RENDER_SHADOW_IN_PSRAM
+            buffer = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+#endif //CONFIG_RENDER_SHADOW_IN_PSRAM
+            if(buffer == nullptr) {
+                buffer = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+            }
+            if(buffer == nullptr) {
+                ESP_LOGW(TAG_RENDER, "No memory for shadow framebuffer (%u "
+                    "bytes). Drawing unbuffered.", (unsigned)size);
+                return RENDER_ERR_NO_MEM;
+            }
+            shadow = new (&shadowStorage) bitmap_type(native, buffer);
+            shadow->clear(shadow->bounds());
+            if constexpr(Rotation == 0) {
+                view = shadow;
+            } else {
+                view = new (&viewStorage) surface_type(*shadow);
+            }
+            return RENDER_OK;
+        }
+
+        void deinitialize() {
+            if(view != nullptr) {
+                if constexpr(Rotation != 0) {
+                    view->~surface_type();
+                }
+                view = nullptr;
+            }
+            if(shadow != nullptr) {
+                shadow->~bitmap_type();
+                shadow = nullptr;
+            }
+            if(buffer != nullptr) {
+                heap_caps_free(buffer);
+                buffer = nullptr;
+            }
+            if(scratch != nullptr) {
+                heap_caps_free(scratch);
+                scratch = nullptr;
+            }
+            packed = false;
+            count = 0;
+            dirty.clear();
+        }
+
+        bool buffered() const { return shadow != nullptr; }
+
+        /**
+         * @brief The shadow framebuffer, nullptr in immediate mode
+         *
+         * Reflects what is on the display as of the last flush. The pixels
+         * are in the panel's native orientation, surface() has them in
+         * screen coordinates.
+         */
+        const bitmap_type *framebuffer() const { return shadow; }
+
+        /**
+         * @brief The shadow framebuffer in screen coordinates, nullptr in
+         *      immediate mode
+         *
+         * Without rotation this is the shadow framebuffer itself, otherwise
+         * a rotated_view of it. Either can be the source of
+         * bcd_render::blit().
+         */
+        const surface_type *surface() const { return view; }
+
+        gfx::rect16 bounds() const { return destination.bounds(); }
+        gfx::size16 dimensions() const { return destination.dimensions(); }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Primitives
+        ////////////////////////////////////////////////////////////////////////
+        template<typename Rect>
+        void clear(const Rect &r) {
+            filled_rectangle(r, gfx::color<pixel_type>::black);
+        }
+
+        template<typename Rect>
+        void filled_rectangle(const Rect &r, pixel_type color) {
+            command *c = record(type_e::FILLED_RECTANGLE, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->color = color;
+                submit(*c);
+            }
+        }
+
+        template<typename Rect>
+        void rectangle(const Rect &r, pixel_type color) {
+            command *c = record(type_e::RECTANGLE, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->color = color;
+                submit(*c);
+            }
+        }
+
+        template<typename Rect>
+        void filled_ellipse(const Rect &r, pixel_type color) {
+            command *c = record(type_e::FILLED_ELLIPSE, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->color = color;
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Records a translucent rectangle
+         *
+         * In immediate mode the display cannot be read back, so the
+         * rectangle is filled opaquely.
+         *
+         * @param alpha Opacity of the colour, 0 (invisible) to 255 (opaque)
+         */
+        template<typename Rect>
+        void blend(const Rect &r, pixel_type color, uint8_t alpha) {
+            command *c = record(type_e::BLEND, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->color = color;
+                c->alpha = alpha;
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Records a text. The string is copied.
+         */
+        template<typename Rect>
+        void text(const Rect &r, const char *str, const gfx::font &font,
+                pixel_type color) {
+            command *c = record(type_e::TEXT, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->color = color;
+                c->font = &font;
+                strncpy(c->str, str, sizeof(c->str) - 1);
+                c->str[sizeof(c->str) - 1] = '\0';
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Records a text on a solid background. The string is copied.
+         *
+         * Cheaper than transparent text if a glyph cache is set, but every
+         * glyph cell is filled with the background colour.
+         */
+        template<typename Rect>
+        void text(const Rect &r, const char *str, const gfx::font &font,
+                pixel_type color, pixel_type background) {
+            command *c = record(type_e::OPAQUE_TEXT, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->color = color;
+                c->background = background;
+                c->font = &font;
+                strncpy(c->str, str, sizeof(c->str) - 1);
+                c->str[sizeof(c->str) - 1] = '\0';
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Records an anti-aliased text. The string is copied.
+         *
+         * The glyphs are read from the atlas at flush time, so it must stay
+         * initialised until then.
+         */
+        template<typename Rect>
+        void text(const Rect &r, const char *str, glyph_atlas &atlas,
+                pixel_type color) {
+            command *c = record(type_e::ATLAS_TEXT, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->color = color;
+                c->atlas = &atlas;
+                strncpy(c->str, str, sizeof(c->str) - 1);
+                c->str[sizeof(c->str) - 1] = '\0';
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Records a bitmap blit.
+         *
+         * The source bitmap is read at flush time, so it must stay valid and
+         * unchanged until then.
+         */
+        template<typename Rect>
+        void bitmap(const Rect &r, const bitmap_type &source,
+                const gfx::rect16 &sourceRect) {
+            command *c = record(type_e::BITMAP, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->source = &source;
+                c->sourceRect = sourceRect;
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Records a blit of read only pixels, like an image mapped
+         *      from flash
+         *
+         * Only the location of the pixels is recorded, so source itself
+         * may be a temporary. The pixels are read at flush time.
+         */
+        template<typename Rect>
+        void bitmap(const Rect &r, const const_bitmap_type &source,
+                const gfx::rect16 &sourceRect) {
+            command *c = record(type_e::CONST_BITMAP, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->pixels = source.begin();
+                c->sourceSize = source.dimensions();
+                c->sourceRect = sourceRect;
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Records a blit of an indexed surface
+         *
+         * The surface is expanded through the palette at flush time, so both
+         * must stay valid and unchanged until then.
+         */
+        template<typename Rect>
+        void indexed(const Rect &r, const indexed_surface &source,
+                const gfx::rect16 &sourceRect,
+                const indexed_palette &palette) {
+            static_assert(pixel_type::bit_depth == 16,
+                "Indexed surfaces expand to RGB565");
+            if(!source.initialized()) {
+                return;
+            }
+            command *c = record(type_e::INDEXED, (gfx::srect16)r);
+            if(c != nullptr) {
+                c->indexed = &source;
+                c->palette = &palette;
+                c->sourceRect = sourceRect;
+                submit(*c);
+            }
+        }
+
+        /**
+         * @brief Draws with any gfx calls that have no primitive
+         *
+         * Flushes the recorded primitives, then runs paint on the shadow
+         * framebuffer, or on the display in immediate mode. The area r is
+         * sent with the next flush.
+         *
+         * @param paint Callable taking the draw target (the shadow
+         *      framebuffer as surface_type, or Destination) and returning a
+         *      gfx_result. Must not draw outside of r.
+         */
+        template<typename Rect, typename Paint>
+        render_err_t compose(const Rect &r, Paint paint) {
+            render_err_t err = flush();
+            if(shadow == nullptr) {
+                return paint(destination) == gfx::gfx_result::success
+                    ? err : RENDER_ERR_DRAW;
+            }
+            gfx::gfx_result res = paint(*view);
+            markDirty((gfx::srect16)r);
+            return res == gfx::gfx_result::success ? err : RENDER_ERR_DRAW;
+        }
+
+        /**
+         * @brief Sets single pixels
+         *
+         * Flushes the recorded primitives, then writes the pixels straight
+         * into the shadow framebuffer. Every pixel is marked dirty on its
+         * own, the dirty set merges the ones close to each other. Pixels
+         * outside of the screen are skipped.
+         *
+         * @param x, y Coordinates of the pixels
+         * @param colors Colour of every pixel
+         * @param previous If not nullptr, receives the colour every pixel had
+         *      before the call, so it can be restored with another call.
+         *      Pixels outside of the screen read as black.
+         * @return RENDER_OK on success, RENDER_ERR_NOT_SUPPORTED if previous
+         *      is given in immediate mode
+         */
+        render_err_t points(const int16_t *x, const int16_t *y,
+                const pixel_type *colors, size_t count,
+                pixel_type *previous = nullptr) {
+            static_assert(pixel_type::bit_depth == 16,
+                "Pixels are written as RGB565");
+            render_err_t err = flush();
+            if(shadow == nullptr) {
+                if(previous != nullptr) {
+                    return RENDER_ERR_NOT_SUPPORTED;
+                }
+                for(size_t i = 0; i < count; i++) {
+                    gfx::draw::point(destination, gfx::spoint16(x[i], y[i]),
+                        colors[i]);
+                }
+                return err;
+            }
+
+            const gfx::size16 size = dimensions();
+            const gfx::size16 native = shadow->dimensions();
+            uint8_t *base = shadow->begin();
+            // All pixels are read before any is written, so pixels that are
+            // set twice still restore to what was there before the call
+            if(previous != nullptr) {
+                for(size_t i = 0; i < count; i++) {
+                    previous[i] = gfx::color<pixel_type>::black;
+                    if(x[i] < 0 || y[i] < 0 || x[i] >= size.width
+                            || y[i] >= size.height) {
+                        continue;
+                    }
+                    const gfx::spoint16 n = transform::point(
+                        gfx::spoint16(x[i], y[i]), native);
+                    const uint8_t *p = base + (n.y * native.width + n.x) * 2;
+                    previous[i].native_value = (p[0] << 8) | p[1];
+                }
+            }
+            for(size_t i = 0; i < count; i++) {
+                if(x[i] < 0 || y[i] < 0 || x[i] >= size.width
+                        || y[i] >= size.height) {
+                    continue;
+                }
+                const gfx::spoint16 n = transform::point(
+                    gfx::spoint16(x[i], y[i]), native);
+                uint8_t *p = base + (n.y * native.width + n.x) * 2;
+                p[0] = colors[i].native_value >> 8;
+                p[1] = colors[i].native_value & 0xff;
+                dirty.add(gfx::rect16(n.x, n.y, n.x, n.y));
+            }
+            return err;
+        }
+
+        /**
+         * @brief Draws text with a background colour from a glyph cache
+         *
+         * @param cache An initialised glyph cache, or nullptr to draw all
+         *      text with draw::text
+         */
+        void use_glyph_cache(glyph_cache *cache) {
+            static_assert(pixel_type::bit_depth == 16,
+                "Glyph tiles are RGB565");
+            glyphs = cache;
+        }
+
+        /**
+         * @brief Allows scroll() to use the scroll registers of the panel
+         *
+         * The controller scrolls along its own lines, which are only the
+         * screen's rows if the panel is not rotated by 90 or 270 degrees.
+         * Needs Rotation to be the rotation of the driver.
+         *
+         * @param panelLines Number of lines of the panel in its native
+         *      orientation
+         * @return RENDER_OK if hardware scrolling is used,
+         *      RENDER_ERR_NOT_SUPPORTED if scroll() repaints instead
+         */
+        render_err_t enable_hardware_scroll(uint16_t panelLines) {
+            if(transform::swapped) {
+                ESP_LOGI(TAG_RENDER, "Panel rotation %d scrolls across screen"
+                    " rows. Scrolling by repaint.", Rotation);
+                return RENDER_ERR_NOT_SUPPORTED;
+            }
+            hwScroll = true;
+            this->panelLines = panelLines;
+            return RENDER_OK;
+        }
+
+        /**
+         * @brief Sends changes inside an area packed as RGB444
+         *
+         * For areas that only show colours with no more than 4 bits per
+         * channel that matter. The panel is in 12 bit mode only while the
+         * area is written, so it can be changed or disabled at any time.
+         *
+         * @param area The area in screen coordinates
+         * @return RENDER_OK, RENDER_ERR_NOT_SUPPORTED in immediate mode or for
+         *      pixels other than RGB565, RENDER_ERR_NO_MEM if there is no
+         *      memory to pack the pixels in
+         */
+        render_err_t enable_rgb444(const gfx::srect16 &area) {
+            if(shadow == nullptr || pixel_type::bit_depth != 16) {
+                return RENDER_ERR_NOT_SUPPORTED;
+            }
+            // Drivers that take raw commands get the pixels packed here,
+            // esp_lcd packs them into its own transfer buffers
+            if(!is_esp_lcd<Destination>::value && scratch == nullptr) {
+                scratch = (uint8_t *)heap_caps_malloc(
+                    panel_io<Destination>::chunk, MALLOC_CAP_8BIT);
+                if(scratch == nullptr) {
+                    return RENDER_ERR_NO_MEM;
+                }
+            }
+            const gfx::srect16 screen = (gfx::srect16)bounds();
+            const gfx::srect16 n = area.normalize();
+            if(!screen.intersects(n)) {
+                packed = false;
+                return RENDER_OK;
+            }
+            packedArea = (gfx::rect16)transform::rect(n.crop(screen),
+                shadow->dimensions());
+            packed = true;
+            return RENDER_OK;
+        }
+
+        /**
+         * @brief Sends everything in RGB565 again
+         */
+        void disable_rgb444() {
+            packed = false;
+        }
+
+        /**
+         * @brief Moves the content of an area down
+         *
+         * The bottom dy lines of the area wrap around to its top, where the
+         * caller is expected to draw new content. Pending primitives are
+         * flushed first.
+         *
+         * With hardware scrolling, the whole screen width of the area's rows
+         * moves on the panel. Content left and right of the area is resent at
+         * its new memory position. Scrolling another range of rows than the
+         * last call resends the previous band once. Otherwise, which is always
+         * the case with a rotation of 90 or 270 degrees, the area is moved in
+         * the shadow framebuffer and sent as a whole.
+         *
+         * @param area The area to scroll, an area outside of the screen only
+         *      flushes
+         * @param dy Number of lines to move down
+         */
+        render_err_t scroll(const gfx::rect16 &area, int16_t dy) {
+            if(shadow == nullptr) {
+                return RENDER_ERR_NOT_INITIALIZED;
+            }
+            const gfx::rect16 n = area.normalize();
+            if(!n.intersects(bounds())) {
+                return flush();
+            }
+            const gfx::rect16 l = n.crop(bounds());
+            dy %= (int16_t)l.height();
+            if(dy < 0) {
+                dy += l.height();
+            }
+            render_err_t err = flush();
+            if(dy == 0) {
+                return err;
+            }
+
+            // From here on everything is in native orientation. Moving down
+            // on the screen is moving down, up, right or left there. Up and
+            // left are the same as moving the other way by the rest of the
+            // area.
+            const gfx::rect16 a = (gfx::rect16)transform::rect(
+                (gfx::srect16)l, shadow->dimensions());
+            dy = Rotation == 0 || Rotation == 3 ? dy : l.height() - dy;
+            if constexpr(transform::swapped) {
+                rotateColumns(a, dy);
+            } else {
+                rotateShadow(a, dy);
+            }
+
+            if(!hwScroll) {
+                dirty.add(a);
+                return err == RENDER_OK ? flush() : err;
+            }
+
+            if(bandHeight != 0 && (a.top() != bandTop
+                    || a.height() != bandHeight)) {
+                // The panel memory of the old band is out of order. Resend
+                // it together with the new band, so no rows of the new band
+                // are overwritten after they have been scrolled.
+                uint16_t top = bandTop < a.top() ? bandTop : a.top();
+                uint16_t bottom = bandTop + bandHeight - 1;
+                if(a.bottom() > bottom) {
+                    bottom = a.bottom();
+                }
+                bandHeight = 0;
+                bandOffset = 0;
+                panel_io<Destination>::normal_mode(destination);
+                dirty.add(gfx::rect16(0, top, shadow->dimensions().width - 1,
+                    bottom));
+            }
+            if(bandHeight == 0) {
+                bandTop = a.top();
+                bandHeight = a.height();
+                bandOffset = 0;
+                if(panel_io<Destination>::scroll_area(destination, bandTop,
+                        bandHeight, panelLines - bandTop - bandHeight)
+                        != RENDER_OK) {
+                    err = RENDER_FAIL;
+                }
+            }
+            bandOffset = (bandOffset + dy) % bandHeight;
+
+            // On the panel, moving content down means starting the area
+            // earlier in memory
+            uint16_t start = bandTop + (bandHeight - bandOffset) % bandHeight;
+            if(panel_io<Destination>::scroll_start(destination, start)
+                    != RENDER_OK) {
+                err = RENDER_FAIL;
+            }
+            scrolls++;
+
+            // Only the area was meant to move
+            uint16_t right = shadow->dimensions().width - 1;
+            if(a.left() > 0) {
+                dirty.add(gfx::rect16(0, a.top(), a.left() - 1, a.bottom()));
+            }
+            if(a.right() < right) {
+                dirty.add(gfx::rect16(a.right() + 1, a.top(), right,
+                    a.bottom()));
+            }
+            return err == RENDER_OK ? flush() : err;
+        }
+
+        /**
+         * @brief Rasterises the recorded primitives and sends the changed
+         *      areas to the display
+         *
+         * @return RENDER_OK on success, RENDER_ERR_DRAW otherwise
+         */
+        render_err_t flush() {
+            if(shadow == nullptr) {
+                count = 0;
+                return RENDER_OK;
+            }
+
+            render_err_t err = RENDER_OK;
+            for(size_t i = 0; i < count; i++) {
+                if(run(*view, commands[i]) != gfx::gfx_result::success) {
+                    err = RENDER_ERR_DRAW;
+                }
+                markDirty(commands[i].bounds);
+            }
+            stats.sequence++;
+            stats.primitives = count;
+            stats.scrolls = scrolls;
+            stats.packed = 0;
+            scrolls = 0;
+            count = 0;
+
+            dirty.coalesce();
+            stats.windows = dirty.size();
+            stats.pixels = dirty.pixels();
+
+            if(dirty.size() > 0) {
+                if(begin() != RENDER_OK) {
+                    err = RENDER_ERR_DRAW;
+                }
+                for(size_t i = 0; i < dirty.size(); i++) {
+                    gfx::rect16 parts[4];
+                    const size_t n = outside(dirty[i], parts);
+                    for(size_t j = 0; j < n; j++) {
+                        if(send(parts[j]) != gfx::gfx_result::success) {
+                            err = RENDER_ERR_DRAW;
+                        }
+                    }
+                }
+                // A rotated list still has the panel in its native order,
+                // without rotation the driver's batch has to be closed
+                if(Rotation != 0 && sendPacked() != RENDER_OK) {
+                    err = RENDER_ERR_DRAW;
+                }
+                if(end() != RENDER_OK) {
+                    err = RENDER_ERR_DRAW;
+                }
+                if(Rotation == 0 && sendPacked() != RENDER_OK) {
+                    err = RENDER_ERR_DRAW;
+                }
+            }
+            dirty.clear();
+
+            totals.sequence = stats.sequence;
+            totals.primitives += stats.primitives;
+            totals.windows += stats.windows;
+            totals.pixels += stats.pixels;
+            totals.scrolls += stats.scrolls;
+            totals.packed += stats.packed;
+
+#ifdef CONFIG_RENDER_LOG_STATS
+            if(stats.primitives != 0 || stats.windows != 0) {
+                ESP_LOGI(TAG_RENDER, "flush %u: %u primitives, %u windows, "
+                    "%u px (%u RGB444), %u scrolls", (unsigned)stats.sequence,
+                    (unsigned)stats.primitives, (unsigned)stats.windows,
+                    (unsigned)stats.pixels, (unsigned)stats.packed,
+                    (unsigned)stats.scrolls);
+            }
+#endif
+
+            return err;
+        }
+
+        const display_list_stats &lastFlush() const { return stats; }
+        const display_list_stats &allFlushes() const { return totals; }
+
+    private:
+        enum class type_e : uint8_t {
+            FILLED_RECTANGLE,
+            RECTANGLE,
+            FILLED_ELLIPSE,
+            BLEND,
+            TEXT,
+            OPAQUE_TEXT,
+            ATLAS_TEXT,
+            BITMAP,
+            CONST_BITMAP,
+            INDEXED,
+        };
+
+        struct command {
+            type_e type;
+            gfx::srect16 bounds;
+            pixel_type color;
+            pixel_type background;
+            uint8_t alpha;
+            const gfx::font *font;
+            glyph_atlas *atlas;
+            const bitmap_type *source;
+            const uint8_t *pixels;
+            gfx::size16 sourceSize;
+            const indexed_surface *indexed;
+            const indexed_palette *palette;
+            gfx::rect16 sourceRect;
+            char str[CONFIG_RENDER_TEXT_LENGTH];
+        };
+
+        Destination &destination;
+        uint8_t *buffer = nullptr;
+        bitmap_type *shadow = nullptr;                                          /**< Native orientation */
+        alignas(bitmap_type) uint8_t shadowStorage[sizeof(bitmap_type)];
+        surface_type *view = nullptr;                                           /**< Screen coordinates */
+        alignas(surface_type) uint8_t viewStorage[sizeof(surface_type)];
+        glyph_cache *glyphs = nullptr;
+
+        // Hardware scroll state. Rows bandTop .. bandTop + bandHeight - 1
+        // are shown moved down by bandOffset lines.
+        bool hwScroll = false;
+        uint16_t panelLines = 0;
+        uint16_t bandTop = 0;
+        uint16_t bandHeight = 0;
+        uint16_t bandOffset = 0;
+        uint32_t scrolls = 0;
+
+        // Area sent as RGB444, in native orientation
+        bool packed = false;
+        bool packing = false;                                                   /**< Panel is in 12 bit mode */
+        gfx::rect16 packedArea;
+        uint8_t *scratch = nullptr;                                             /**< Pixels packed for panel_io::write_rgb444() */
+
+        command commands[Capacity];
+        size_t count = 0;
+        dirty_rects dirty;
+        display_list_stats stats;
+        display_list_stats totals;
+
+        // Returns the next free slot, flushing first if the list is full
+        command *record(type_e type, const gfx::srect16 &bounds) {
+            if(shadow != nullptr && count == Capacity) {
+                flush();
+            }
+            command *c = shadow == nullptr ? &commands[0] : &commands[count];
+            c->type = type;
+            c->bounds = bounds.normalize();
+            return c;
+        }
+
+        // In immediate mode the command goes straight to the display
+        void submit(const command &c) {
+            if(shadow == nullptr) {
+                run(destination, c);
+            } else {
+                count++;
+            }
+        }
+
+        // Prepares the display for the windows of a flush. A rotated list
+        // writes in the panel's native order.
+        render_err_t begin() {
+            if constexpr(Rotation == 0) {
+                gfx::draw::suspend(destination);
+                return RENDER_OK;
+            } else {
+                return panel_io<Destination>::scan_order(destination, 0);
+            }
+        }
+
+        render_err_t end() {
+            if constexpr(Rotation == 0) {
+                gfx::draw::resume(destination);
+                return RENDER_OK;
+            } else {
+                return panel_io<Destination>::scan_order(destination,
+                    Rotation);
+            }
+        }
+
+        // Writes the area from of the shadow framebuffer to the area to of
+        // the panel. Without rotation the driver does it, otherwise the rows
+        // go out as they are in the shadow.
+        gfx::gfx_result write(const gfx::srect16 &to,
+                const gfx::rect16 &from) {
+            if(packing) {
+                const size_t stride = shadow->dimensions().width * 2;
+                return panel_io<Destination>::write_rgb444(destination,
+                    (gfx::rect16)to, buffer + from.top() * stride
+                        + from.left() * 2, stride, scratch) == RENDER_OK
+                    ? gfx::gfx_result::success : gfx::gfx_result::io_error;
+            }
+            if constexpr(Rotation == 0) {
+                return gfx::draw::bitmap(destination, to, *shadow, from);
+            } else {
+                const size_t stride = shadow->dimensions().width * 2;
+                return panel_io<Destination>::write(destination,
+                    (gfx::rect16)to, buffer + from.top() * stride
+                        + from.left() * 2, stride) == RENDER_OK
+                    ? gfx::gfx_result::success : gfx::gfx_result::io_error;
+            }
+        }
+
+        // Splits a dirty area into the parts outside the RGB444 area, which
+        // are sent in 16 bit. Returns the number of parts.
+        size_t outside(const gfx::rect16 &r, gfx::rect16 parts[4]) const {
+            if(!packed || !r.intersects(packedArea)) {
+                parts[0] = r;
+                return 1;
+            }
+            const gfx::rect16 in = r.crop(packedArea);
+            size_t n = 0;
+            if(r.top() < in.top()) {
+                parts[n++] = gfx::rect16(r.left(), r.top(), r.right(),
+                    in.top() - 1);
+            }
+            if(r.bottom() > in.bottom()) {
+                parts[n++] = gfx::rect16(r.left(), in.bottom() + 1, r.right(),
+                    r.bottom());
+            }
+            if(r.left() < in.left()) {
+                parts[n++] = gfx::rect16(r.left(), in.top(), in.left() - 1,
+                    in.bottom());
+            }
+            if(r.right() > in.right()) {
+                parts[n++] = gfx::rect16(in.right() + 1, in.top(), r.right(),
+                    in.bottom());
+            }
+            return n;
+        }
+
+        // Sends the dirty parts inside the RGB444 area with the panel in
+        // 12 bit mode
+        render_err_t sendPacked() {
+            if(!packed) {
+                return RENDER_OK;
+            }
+            render_err_t err = RENDER_OK;
+            for(size_t i = 0; i < dirty.size(); i++) {
+                if(!dirty[i].intersects(packedArea)) {
+                    continue;
+                }
+                const gfx::rect16 in = dirty[i].crop(packedArea);
+                if(!packing) {
+                    if(panel_io<Destination>::pixel_format(destination, 12)
+                            != RENDER_OK) {
+                        return RENDER_ERR_DRAW;
+                    }
+                    packing = true;
+                }
+                if(send(in) != gfx::gfx_result::success) {
+                    err = RENDER_ERR_DRAW;
+                }
+                stats.packed += in.width() * in.height();
+            }
+            if(packing) {
+                packing = false;
+                if(panel_io<Destination>::pixel_format(destination, 16)
+                        != RENDER_OK) {
+                    err = RENDER_ERR_DRAW;
+                }
+            }
+            return err;
+        }
+
+        // Sends an area of the shadow framebuffer to where the panel
+        // currently shows it. Rows in a scrolled band live at
+        // bandTop + (y - bandTop - bandOffset) mod bandHeight in panel
+        // memory, so an area crossing the wrap point is sent in two parts.
+        gfx::gfx_result send(const gfx::rect16 &r) {
+            if(bandOffset == 0 || r.bottom() < bandTop
+                    || r.top() >= bandTop + bandHeight) {
+                return write((gfx::srect16)r, r);
+            }
+
+            gfx::gfx_result result = gfx::gfx_result::success;
+            uint16_t bandBottom = bandTop + bandHeight - 1;
+            uint16_t wrap = bandTop + bandOffset;
+            gfx::rect16 parts[4] = {
+                gfx::rect16(r.left(), r.top(), r.right(), bandTop - 1),
+                gfx::rect16(r.left(), bandTop, r.right(), wrap - 1),
+                gfx::rect16(r.left(), wrap, r.right(), bandBottom),
+                gfx::rect16(r.left(), bandBottom + 1, r.right(), r.bottom())
+            };
+            int16_t shift[4] = { 0, (int16_t)(bandHeight - bandOffset),
+                (int16_t)-bandOffset, 0 };
+            for(int i = 0; i < 4; i++) {
+                if(parts[i].y1 > parts[i].y2 || parts[i].y2 < r.top()
+                        || parts[i].y1 > r.bottom()
+                        || (i == 0 && r.top() >= bandTop)
+                        || (i == 3 && r.bottom() <= bandBottom)) {
+                    continue;
+                }
+                gfx::rect16 src = parts[i].crop(r);
+                gfx::gfx_result res = write(
+                    ((gfx::srect16)src).offset(0, shift[i]), src);
+                if(res != gfx::gfx_result::success) {
+                    result = res;
+                }
+            }
+            return result;
+        }
+
+        // Moves the rows of an area down by dy, wrapping the bottom rows to
+        // the top. Keeps the shadow framebuffer identical to the panel. The
+        // rows are rotated in place along the cycles of the rotation, every
+        // row once per column chunk, so a scroll step needs no memory.
+        void rotateShadow(const gfx::rect16 &a, int16_t dy) {
+            static_assert(pixel_type::bit_depth % 8 == 0,
+                "Scrolling needs byte aligned pixels");
+            constexpr size_t bpp = pixel_type::bit_depth / 8;
+            const size_t stride = shadow->dimensions().width * bpp;
+            const size_t len = a.width() * bpp;
+            const uint16_t h = a.height();
+            uint8_t *base = buffer + a.top() * stride + a.left() * bpp;
+            uint16_t cycles = h;
+            for(uint16_t d = dy; d != 0; ) {
+                uint16_t t = cycles % d;
+                cycles = d;
+                d = t;
+            }
+            uint8_t held[64];
+            for(size_t x = 0; x < len; x += sizeof(held)) {
+                const size_t n = len - x < sizeof(held) ? len - x
+                    : sizeof(held);
+                for(uint16_t c = 0; c < cycles; c++) {
+                    // Row to gets the row dy above it, until the cycle is
+                    // back at the row that was set aside
+                    memcpy(held, base + c * stride + x, n);
+                    uint16_t to = c;
+                    for(uint16_t from = (c + h - dy) % h; from != c;
+                            from = (from + h - dy) % h) {
+                        memcpy(base + to * stride + x,
+                            base + from * stride + x, n);
+                        to = from;
+                    }
+                    memcpy(base + to * stride + x, held, n);
+                }
+            }
+        }
+
+        // Moves the columns of an area right by dx, wrapping the rightmost
+        // columns to the left. Only rotated lists move columns, so the
+        // pixels are RGB565.
+        void rotateColumns(const gfx::rect16 &a, int16_t dx) {
+            const size_t stride = shadow->dimensions().width;
+            uint16_t *row = (uint16_t *)buffer + a.top() * stride + a.left();
+            for(uint16_t y = a.top(); y <= a.bottom(); y++, row += stride) {
+                std::rotate(row, row + a.width() - dx, row + a.width());
+            }
+        }
+
+        // Marks an area given in screen coordinates
+        void markDirty(const gfx::srect16 &r) {
+            gfx::srect16 screen = (gfx::srect16)bounds();
+            if(!screen.intersects(r)) {
+                return;
+            }
+            dirty.add((gfx::rect16)transform::rect(r.crop(screen),
+                shadow->dimensions()));
+        }
+
+        template<typename Target>
+        gfx::gfx_result run(Target &target, const command &c) {
+            if(c.type == type_e::INDEXED) {
+                return expand(c);
+            }
+            if(c.type == type_e::OPAQUE_TEXT && glyphs != nullptr
+                    && glyphs->initialized()) {
+                gfx::gfx_result res = shadow == nullptr
+                    ? glyphs->draw(destination, c.bounds, c.str, *c.font,
+                        c.color, c.background)
+                    : Rotation == 0
+                    ? glyphs->draw(buffer, shadow->dimensions(), c.bounds,
+                        c.str, *c.font, c.color, c.background)
+                    : glyphs->draw(*view, c.bounds, c.str, *c.font, c.color,
+                        c.background);
+                if(res == gfx::gfx_result::success) {
+                    return res;
+                }
+                // A glyph too large for the cache, the text is redrawn as
+                // a whole
+            }
+            return execute(target, c);
+        }
+
+        // Indexed surfaces are expanded row by row. With an unrotated shadow
+        // framebuffer the rows are expanded in place, otherwise through a
+        // small line buffer into the rotated shadow or straight to the
+        // display.
+        gfx::gfx_result expand(const command &c) {
+            gfx::srect16 screen = (gfx::srect16)destination.bounds();
+            if(!screen.intersects(c.bounds)) {
+                return gfx::gfx_result::success;
+            }
+            gfx::srect16 dst = c.bounds.crop(screen);
+            gfx::rect16 src = c.sourceRect.normalize();
+            uint16_t sx = src.left() + (dst.left() - c.bounds.left());
+            uint16_t sy = src.top() + (dst.top() - c.bounds.top());
+            uint16_t w = dst.width() < src.width() ? dst.width() : src.width();
+            uint16_t h = dst.height() < src.height() ? dst.height()
+                : src.height();
+            if(sx + w > c.indexed->dimensions().width
+                    || sy + h > c.indexed->dimensions().height) {
+                return gfx::gfx_result::invalid_argument;
+            }
+
+            if(shadow == nullptr) {
+                return expandLines(destination, c, dst, sx, sy, w, h);
+            }
+            if constexpr(Rotation != 0) {
+                return expandLines(*view, c, dst, sx, sy, w, h);
+            }
+            const size_t stride = shadow->dimensions().width * 2;
+            for(uint16_t y = 0; y < h; y++) {
+                c.indexed->expand(sx, sy + y, w, *c.palette,
+                    buffer + (dst.top() + y) * stride + dst.left() * 2);
+            }
+            return gfx::gfx_result::success;
+        }
+
+        template<typename Target>
+        gfx::gfx_result expandLines(Target &target, const command &c,
+                const gfx::srect16 &dst, uint16_t sx, uint16_t sy,
+                uint16_t w, uint16_t h) {
+            static constexpr uint16_t chunk = 64;
+            uint16_t line[chunk];
+            for(uint16_t y = 0; y < h; y++) {
+                for(uint16_t x = 0; x < w; x += chunk) {
+                    uint16_t n = w - x < chunk ? w - x : chunk;
+                    c.indexed->expand(sx + x, sy + y, n, *c.palette,
+                        (uint8_t *)line);
+                    bitmap_type segment(gfx::size16(n, 1), line);
+                    gfx::gfx_result r = bcd_render::blit(target,
+                        gfx::srect16(gfx::spoint16(dst.left() + x,
+                            dst.top() + y), gfx::ssize16(n, 1)),
+                        segment, segment.bounds());
+                    if(r != gfx::gfx_result::success) {
+                        return r;
+                    }
+                }
+            }
+            return gfx::gfx_result::success;
+        }
+
+        template<typename Target>
+        static gfx::gfx_result execute(Target &target, const command &c) {
+            switch(c.type) {
+                case type_e::FILLED_RECTANGLE:
+                    return bcd_render::fill(target, c.bounds, c.color);
+                case type_e::RECTANGLE:
+                    return gfx::draw::rectangle(target, c.bounds, c.color);
+                case type_e::FILLED_ELLIPSE:
+                    return gfx::draw::filled_ellipse(target, c.bounds,
+                        c.color);
+                case type_e::BLEND:
+                    return bcd_render::blend(target, c.bounds, c.color,
+                        c.alpha);
+                case type_e::TEXT:
+                    return gfx::draw::text(target, c.bounds, c.str, *c.font,
+                        c.color);
+                case type_e::OPAQUE_TEXT:
+                    return gfx::draw::text(target, c.bounds, c.str, *c.font,
+                        c.color, c.background, false);
+                case type_e::ATLAS_TEXT:
+                    return c.atlas->draw(target, c.bounds, c.str, c.color);
+                case type_e::BITMAP:
+                    return bcd_render::blit(target, c.bounds, *c.source,
+                        c.sourceRect);
+                case type_e::CONST_BITMAP:
+                    return bcd_render::blit(target, c.bounds,
+                        const_bitmap_type(c.sourceSize, c.pixels),
+                        c.sourceRect);
+                case type_e::INDEXED:
+                    break;
+            }
+            return gfx::gfx_result::invalid_argument;
+        }
+};
+
+} // namespace bcd_render
@@ -0,0 +1,650 @@
+/**
+ * @file    bcd_esp_lcd.hpp
+ * @brief   ST7735 draw target on top of the esp_lcd panel IO
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * An alternative to espidf::st7735 that talks to the panel through ESP-IDF's
+ * esp_lcd_panel_io_spi instead of its own spi_master transactions. It has the
+ * same template parameters and draw target interface, so it is chosen in
+ * menuconfig (Display Configuration > Display driver backend) and replaces
+ * lcd_type without touching any drawing code.
+ *
+ * Pixels are sent with DMA from two buffers of BufferSize / 2 bytes in
+ * internal RAM. While one buffer is on the bus, the next area is converted
+ * into the other one. The end of every colour transfer is signalled by the
+ * on_color_trans_done callback from the SPI interrupt, so the drawing task
+ * blocks on a semaphore instead of polling. Bitmaps that already are in DMA
+ * capable memory and span full rows are sent without copying. esp_lcd splits
+ * those into transactions of the bus transfer size and queues up to
+ * CONFIG_LCD_ESP_LCD_QUEUE_DEPTH of them at once.
+ *
+ * Synchronous calls return as soon as their last transfer is queued. Only
+ * copies sent without copying wait for the transfer, since the caller may
+ * change the bitmap right after. The _async variants never wait,
+ * wait_all_async() does.
+ *
+ * statistics() counts transfers, bytes and the time spent blocked on the
+ * bus, which mod_benchmark turns into CPU occupancy per case.
+ *
+ * Usage (see bcd_system.hpp):
+ *      using lcd_type = bcd_render::esp_lcd_st7735<LCD_WIDTH, LCD_HEIGHT,
+ *          LCD_HOST, PIN_NUM_CS, PIN_NUM_DC, PIN_NUM_RST, PIN_NUM_BCKL,
+ *          LCD_ROTATION, SPI_BUFFER_SIZE>;
+ */
+#pragma once
+
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+#include "bcd_rgb565.hpp"
+
+// ST7735 commands used by the esp_lcd backend
+#define ST7735_SWRESET  0x01                                                    /**< Software reset */
+#define ST7735_SLPOUT   0x11                                                    /**< Sleep out */
+#define ST7735_DISPON   0x29                                                    /**< Display on */
+#define ST7735_CASET    0x2A                                                    /**< Column address set */
+#define ST7735_RASET    0x2B                                                    /**< Row address set */
+#define ST7735_RAMWR    0x2C                                                    /**< Memory write */
+#define ST7735_MADCTL   0x36                                                    /**< Memory data access control */
+#define ST7735_COLMOD   0x3A                                                    /**< Interface pixel format */
+
+#ifndef CONFIG_LCD_ESP_LCD_CLOCK_MHZ
+#define CONFIG_LCD_ESP_LCD_CLOCK_MHZ 26
+#endif
+#ifndef CONFIG_LCD_ESP_LCD_QUEUE_DEPTH
+#define CONFIG_LCD_ESP_LCD_QUEUE_DEPTH 10
+#endif
+
+namespace bcd_render {
+
+/**
+ * @brief MADCTL value of a rotation of the ST7735R: MY, MX and MV, and the
+ *      colour order chosen in menuconfig
+ */
+inline uint8_t st7735_madctl(uint8_t rotation) {
+    static const uint8_t rotations[4] = { 0xC0, 0xA0, 0x00, 0x60 };
+    uint8_t madctl = rotations[rotation & 3];
+#ifdef CONFIG_MAD_BGR
+    madctl |= 0x08;
+#endif
+    return madctl;
+}
+
+struct esp_lcd_statistics {
+    uint32_t transfers = 0;                                                     /**< Colour transfers queued */
+    uint64_t bytes = 0;                                                         /**< Pixel bytes sent */
+    int64_t waitUs = 0;                                                         /**< Time blocked on the bus */
+};
+
+template<uint16_t Width, uint16_t Height, spi_host_device_t Host,
+        gpio_num_t PinCS, gpio_num_t PinDC, gpio_num_t PinRst,
+        gpio_num_t PinBckl, uint8_t Rotation = 0, size_t BufferSize = 4096>
+class esp_lcd_st7735 {
+    public:
+        using type = esp_lcd_st7735;
+        using pixel_type = gfx::rgb_pixel<16>;
+        using caps = gfx::gfx_caps<false, true, true, true, false, false,
+            false>;
+
+        constexpr static const uint16_t width = Width;
+        constexpr static const uint16_t height = Height;
+
+        static_assert(BufferSize / 2 >= (Width > Height ? Width : Height)
+            * sizeof(uint16_t), "A buffer must hold a row of pixels");
+
+        esp_lcd_st7735() = default;
+        esp_lcd_st7735(const esp_lcd_st7735 &) = delete;
+        esp_lcd_st7735 &operator=(const esp_lcd_st7735 &) = delete;
+        ~esp_lcd_st7735() { deinitialize(); }
+
+        /**
+         * @brief Attaches the panel to the SPI bus and runs the ST7735 init
+         *      sequence
+         *
+         * The bus must be initialised already (bcd_system's spi_master does
+         * that). Every drawing call initialises the panel if needed.
+         */
+        gfx::gfx_result initialize() {
+            if(io != nullptr) {
+                return gfx::gfx_result::success;
+            }
+            for(size_t i = 0; i < 2; i++) {
+                buffers[i] = (uint8_t *)heap_caps_malloc(bufferSize,
+                    MALLOC_CAP_DMA);
+            }
+            done = xSemaphoreCreateBinary();
+            if(buffers[0] == nullptr || buffers[1] == nullptr
+                    || done == nullptr) {
+                ESP_LOGE(TAG_RENDER, "No memory for the esp_lcd buffers.");
+                deinitialize();
+                return gfx::gfx_result::out_of_memory;
+            }
+
+            esp_lcd_panel_io_spi_config_t config = {};
+            config.cs_gpio_num = PinCS;
+            config.dc_gpio_num = PinDC;
+            config.spi_mode = 0;
+            config.pclk_hz = CONFIG_LCD_ESP_LCD_CLOCK_MHZ * 1000 * 1000;
+            config.trans_queue_depth = CONFIG_LCD_ESP_LCD_QUEUE_DEPTH;
+            config.on_color_trans_done = transferDone;
+            config.user_ctx = this;
+            config.lcd_cmd_bits = 8;
+            config.lcd_param_bits = 8;
+            esp_lcd_panel_io_handle_t handle = nullptr;
+            if(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)Host,
+                    &config, &handle) != ESP_OK) {
+                ESP_LOGE(TAG_RENDER, "Cannot attach the panel to the bus.");
+                deinitialize();
+                return gfx::gfx_result::io_error;
+            }
+            io = handle;
+            queued = completed = 0;
+            inflight = none;
+            windowValid = false;
+
+            if(PinBckl != GPIO_NUM_NC) {
+                gpio_reset_pin(PinBckl);
+                gpio_set_direction(PinBckl, GPIO_MODE_OUTPUT);
+                gpio_set_level(PinBckl, 0);
+            }
+            if(PinRst != GPIO_NUM_NC) {
+                gpio_reset_pin(PinRst);
+                gpio_set_direction(PinRst, GPIO_MODE_OUTPUT);
+                gpio_set_level(PinRst, 0);
+                vTaskDelay(pdMS_TO_TICKS(10));
+                gpio_set_level(PinRst, 1);
+                vTaskDelay(pdMS_TO_TICKS(120));
+            }
+            if(init() != ESP_OK) {
+                ESP_LOGE(TAG_RENDER, "ST7735 init sequence failed.");
+                deinitialize();
+                return gfx::gfx_result::io_error;
+            }
+            if(PinBckl != GPIO_NUM_NC) {
+                gpio_set_level(PinBckl, 1);
+            }
+            return gfx::gfx_result::success;
+        }
+
+        void deinitialize() {
+            if(io != nullptr) {
+                drain();
+                esp_lcd_panel_io_del(io);
+                io = nullptr;
+            }
+            for(size_t i = 0; i < 2; i++) {
+                if(buffers[i] != nullptr) {
+                    heap_caps_free(buffers[i]);
+                    buffers[i] = nullptr;
+                }
+            }
+            if(done != nullptr) {
+                vSemaphoreDelete(done);
+                done = nullptr;
+            }
+        }
+
+        bool initialized() const { return io != nullptr; }
+
+        gfx::size16 dimensions() const {
+            return Rotation & 1 ? gfx::size16(Height, Width)
+                : gfx::size16(Width, Height);
+        }
+        gfx::rect16 bounds() const { return dimensions().bounds(); }
+
+        /**
+         * @brief Sends a raw command with optional parameter bytes, after all
+         *      queued pixels
+         */
+        esp_err_t command(uint8_t cmd, const uint8_t *params = nullptr,
+                size_t size = 0) {
+            if(initialize() != gfx::gfx_result::success) {
+                return ESP_FAIL;
+            }
+            drain();
+            // The command may move the address window
+            windowValid = false;
+            return esp_lcd_panel_io_tx_param(io, cmd, params, size);
+        }
+
+        /**
+         * @brief Writes pixels to a window of panel memory as they are
+         *
+         * The window is neither rotated nor clipped, it addresses the memory
+         * in whatever order MADCTL currently sets (see panel_io::write()).
+         * Returns once the pixels are no longer read.
+         *
+         * @param r The window
+         * @param first First byte of the pixels, in framebuffer byte order
+         * @param stride Bytes from one row of the pixels to the next
+         */
+        gfx::gfx_result write_memory(const gfx::rect16 &r,
+                const uint8_t *first, size_t stride) {
+            gfx::gfx_result res = initialize();
+            if(res == gfx::gfx_result::success) {
+                res = sendRows(r, first, stride, false);
+            }
+            return res;
+        }
+
+        /**
+         * @brief Writes pixels to a window of panel memory packed as RGB444
+         *
+         * Like write_memory(), for a panel switched to its 12 bit interface
+         * mode (see panel_io::pixel_format()). The pixels are packed into
+         * the buffers, every chunk of rows is a window of its own.
+         *
+         * @param r The window
+         * @param first First byte of the RGB565 pixels, in framebuffer byte
+         *      order
+         * @param stride Bytes from one row of the pixels to the next
+         */
+        gfx::gfx_result write_memory_rgb444(const gfx::rect16 &r,
+                const uint8_t *first, size_t stride) {
+            gfx::gfx_result res = initialize();
+            if(res != gfx::gfx_result::success) {
+                return res;
+            }
+            const uint16_t w = r.width();
+            const uint16_t rows = bufferSize * 2 / 3 / w;
+            for(uint16_t y = r.y1; y <= r.y2; y += rows) {
+                uint16_t y2 = y + rows - 1 < r.y2 ? y + rows - 1 : r.y2;
+                const int b = freeBuffer();
+                const size_t size = rgb565::pack444(buffers[b], first, stride,
+                    w, y2 - y + 1);
+                res = send(gfx::rect16(r.x1, y, r.x2, y2), buffers[b], size,
+                    b);
+                if(res != gfx::gfx_result::success) {
+                    return res;
+                }
+                first += stride * (y2 - y + 1);
+            }
+            return gfx::gfx_result::success;
+        }
+
+        gfx::gfx_result point(gfx::point16 location, pixel_type color) {
+            return fill(gfx::rect16(location, gfx::size16(1, 1)), color);
+        }
+        gfx::gfx_result point_async(gfx::point16 location, pixel_type color) {
+            return point(location, color);
+        }
+
+        gfx::gfx_result fill(const gfx::rect16 &bounds, pixel_type color) {
+            gfx::gfx_result res = initialize();
+            if(res != gfx::gfx_result::success) {
+                return res;
+            }
+            if(!bounds.intersects(this->bounds())) {
+                return gfx::gfx_result::success;
+            }
+            const gfx::rect16 r = bounds.normalize().crop(this->bounds());
+            const uint16_t w = r.width();
+            const uint16_t rows = chunkRows(w) < r.height() ? chunkRows(w)
+                : r.height();
+
+            // The buffer holds the colour for a whole chunk and is sent for
+            // every chunk of the area
+            const int b = freeBuffer();
+            uint16_t *px = (uint16_t *)buffers[b];
+            const uint16_t value = swap(color.native_value);
+            for(size_t i = 0; i < (size_t)w * rows; i++) {
+                px[i] = value;
+            }
+            for(uint16_t y = r.y1; y <= r.y2; y += rows) {
+                uint16_t y2 = y + rows - 1 < r.y2 ? y + rows - 1 : r.y2;
+                res = send(gfx::rect16(r.x1, y, r.x2, y2), buffers[b],
+                    (size_t)w * (y2 - y + 1) * sizeof(uint16_t), b);
+                if(res != gfx::gfx_result::success) {
+                    return res;
+                }
+            }
+            return gfx::gfx_result::success;
+        }
+        gfx::gfx_result fill_async(const gfx::rect16 &bounds,
+                pixel_type color) {
+            return fill(bounds, color);
+        }
+
+        gfx::gfx_result clear(const gfx::rect16 &bounds) {
+            return fill(bounds, pixel_type());
+        }
+        gfx::gfx_result clear_async(const gfx::rect16 &bounds) {
+            return clear(bounds);
+        }
+
+        template<typename Source>
+        gfx::gfx_result copy_from(const gfx::rect16 &src_rect,
+                const Source &src, gfx::point16 location) {
+            return copy(src_rect, src, location, false);
+        }
+        template<typename Source>
+        gfx::gfx_result copy_from_async(const gfx::rect16 &src_rect,
+                const Source &src, gfx::point16 location) {
+            return copy(src_rect, src, location, true);
+        }
+
+        gfx::gfx_result begin_batch(const gfx::rect16 &bounds) {
+            gfx::gfx_result res = commit_batch();
+            if(res != gfx::gfx_result::success) {
+                return res;
+            }
+            res = initialize();
+            if(res != gfx::gfx_result::success) {
+                return res;
+            }
+            batch = bounds.normalize().crop(this->bounds());
+            batchRow = batch.y1;
+            batchBuffer = freeBuffer();
+            batchPixels = 0;
+            batchOpen = true;
+            return gfx::gfx_result::success;
+        }
+        gfx::gfx_result begin_batch_async(const gfx::rect16 &bounds) {
+            return begin_batch(bounds);
+        }
+
+        gfx::gfx_result write_batch(pixel_type color) {
+            if(!batchOpen) {
+                return gfx::gfx_result::invalid_state;
+            }
+            ((uint16_t *)buffers[batchBuffer])[batchPixels++] =
+                swap(color.native_value);
+            if(batchPixels == (size_t)batch.width() * chunkRows(batch.width())) {
+                return flushBatch();
+            }
+            return gfx::gfx_result::success;
+        }
+        gfx::gfx_result write_batch_async(pixel_type color) {
+            return write_batch(color);
+        }
+
+        gfx::gfx_result commit_batch() {
+            if(!batchOpen) {
+                return gfx::gfx_result::success;
+            }
+            gfx::gfx_result res = batchPixels > 0 ? flushBatch()
+                : gfx::gfx_result::success;
+            batchOpen = false;
+            return res;
+        }
+        gfx::gfx_result commit_batch_async() {
+            return commit_batch();
+        }
+
+        /**
+         * @brief Waits until every queued transfer is on the panel
+         */
+        gfx::gfx_result wait_all_async() {
+            gfx::gfx_result res = commit_batch();
+            drain();
+            return res;
+        }
+
+        const esp_lcd_statistics &statistics() const { return stats; }
+
+    private:
+        static constexpr size_t bufferSize = BufferSize / 2 & ~(size_t)3;
+        static constexpr int none = -1;                                         /**< No buffer in flight */
+        static constexpr int external = 2;                                      /**< Caller's memory in flight */
+
+        esp_lcd_panel_io_handle_t io = nullptr;
+        uint8_t *buffers[2] = { nullptr, nullptr };
+        SemaphoreHandle_t done = nullptr;                                       /**< Given at the end of a transfer */
+        volatile uint32_t queued = 0;                                           /**< Colour transfers started */
+        volatile uint32_t completed = 0;                                        /**< Colour transfers finished */
+        int inflight = none;                                                    /**< Buffer of the last transfer */
+        gfx::rect16 window;                                                     /**< Address window last set */
+        bool windowValid = false;
+        gfx::rect16 batch;
+        uint16_t batchRow = 0;                                                  /**< First row not sent yet */
+        int batchBuffer = 0;
+        size_t batchPixels = 0;
+        bool batchOpen = false;
+        esp_lcd_statistics stats;
+
+        static uint16_t swap(uint16_t v) { return (v >> 8) | (v << 8); }
+
+        // Rows of the given width that fit into one buffer
+        static uint16_t chunkRows(uint16_t w) {
+            return bufferSize / sizeof(uint16_t) / w;
+        }
+
+        static IRAM_ATTR bool transferDone(esp_lcd_panel_io_handle_t io,
+                esp_lcd_panel_io_event_data_t *edata, void *ctx) {
+            esp_lcd_st7735 *self = (esp_lcd_st7735 *)ctx;
+            BaseType_t woken = pdFALSE;
+            self->completed = self->completed + 1;
+            xSemaphoreGiveFromISR(self->done, &woken);
+            return woken == pdTRUE;
+        }
+
+        // Blocks until all colour transfers finished. esp_lcd waits for them
+        // itself before the next command, but would not count the time.
+        void drain() {
+            if(completed == queued) {
+                inflight = none;
+                return;
+            }
+            int64_t start = esp_timer_get_time();
+            while(completed != queued) {
+                xSemaphoreTake(done, portMAX_DELAY);
+            }
+            stats.waitUs += esp_timer_get_time() - start;
+            inflight = none;
+        }
+
+        // The buffer that is not on the bus
+        int freeBuffer() const { return inflight == 0 ? 1 : 0; }
+
+        // Queues data for the area r. The previous transfer is finished
+        // first, so at most one buffer is ever on the bus.
+        gfx::gfx_result send(const gfx::rect16 &r, const void *data,
+                size_t size, int buffer) {
+            drain();
+            if(!windowValid || r.x1 != window.x1 || r.x2 != window.x2) {
+                const uint8_t caset[4] = { (uint8_t)(r.x1 >> 8),
+                    (uint8_t)r.x1, (uint8_t)(r.x2 >> 8), (uint8_t)r.x2 };
+                if(esp_lcd_panel_io_tx_param(io, ST7735_CASET, caset,
+                        sizeof(caset)) != ESP_OK) {
+                    windowValid = false;
+                    return gfx::gfx_result::io_error;
+                }
+            }
+            if(!windowValid || r.y1 != window.y1 || r.y2 != window.y2) {
+                const uint8_t raset[4] = { (uint8_t)(r.y1 >> 8),
+                    (uint8_t)r.y1, (uint8_t)(r.y2 >> 8), (uint8_t)r.y2 };
+                if(esp_lcd_panel_io_tx_param(io, ST7735_RASET, raset,
+                        sizeof(raset)) != ESP_OK) {
+                    windowValid = false;
+                    return gfx::gfx_result::io_error;
+                }
+            }
+            window = r;
+            windowValid = true;
+
+            queued = queued + 1;
+            if(esp_lcd_panel_io_tx_color(io, ST7735_RAMWR, data, size)
+                    != ESP_OK) {
+                queued = queued - 1;
+                return gfx::gfx_result::io_error;
+            }
+            inflight = buffer;
+            stats.transfers++;
+            stats.bytes += size;
+            return gfx::gfx_result::success;
+        }
+
+        gfx::gfx_result flushBatch() {
+            const uint16_t w = batch.width();
+            const uint16_t rows = (batchPixels + w - 1) / w;
+            gfx::gfx_result res = send(gfx::rect16(batch.x1, batchRow,
+                batch.x2, batchRow + rows - 1), buffers[batchBuffer],
+                batchPixels * sizeof(uint16_t), batchBuffer);
+            batchRow += rows;
+            batchBuffer = freeBuffer();
+            batchPixels = 0;
+            return res;
+        }
+
+        template<typename Source>
+        gfx::gfx_result copy(const gfx::rect16 &src_rect, const Source &src,
+                gfx::point16 location, bool async) {
+            gfx::gfx_result res = initialize();
+            if(res != gfx::gfx_result::success) {
+                return res;
+            }
+            const gfx::rect16 sr = src_rect.normalize();
+            const gfx::rect16 dst(location, sr.dimensions());
+            if(!dst.intersects(bounds())) {
+                return gfx::gfx_result::success;
+            }
+            const gfx::rect16 r = dst.crop(bounds());
+            const uint16_t sx = sr.x1 + r.x1 - dst.x1;
+            const uint16_t sy = sr.y1 + r.y1 - dst.y1;
+            const uint16_t w = r.width();
+            const uint16_t rows = chunkRows(w);
+
+            if constexpr(std::is_same<typename Source::pixel_type,
+                    pixel_type>::value && Source::caps::blt) {
+                // Same format as on the wire, rows are copied or sent as is
+                const size_t stride = src.dimensions().width * sizeof(uint16_t);
+                return sendRows(r, src.begin() + sy * stride
+                    + sx * sizeof(uint16_t), stride, async);
+            } else {
+                for(uint16_t y = r.y1; y <= r.y2; y += rows) {
+                    uint16_t y2 = y + rows - 1 < r.y2 ? y + rows - 1 : r.y2;
+                    const int b = freeBuffer();
+                    uint16_t *out = (uint16_t *)buffers[b];
+                    for(uint16_t row = y; row <= y2; row++) {
+                        for(uint16_t x = 0; x < w; x++) {
+                            typename Source::pixel_type sp;
+                            res = src.point(gfx::point16(sx + x,
+                                sy + row - r.y1), &sp);
+                            if(res != gfx::gfx_result::success) {
+                                return res;
+                            }
+                            pixel_type dp;
+                            res = gfx::convert(sp, &dp);
+                            if(res != gfx::gfx_result::success) {
+                                return res;
+                            }
+                            *out++ = swap(dp.native_value);
+                        }
+                    }
+                    res = send(gfx::rect16(r.x1, y, r.x2, y2), buffers[b],
+                        (uint8_t *)out - buffers[b], b);
+                    if(res != gfx::gfx_result::success) {
+                        return res;
+                    }
+                }
+                return gfx::gfx_result::success;
+            }
+        }
+
+        // Sends rows of pixels in wire format to the window r. Full rows in
+        // DMA capable memory go out without copying, everything else through
+        // the buffers.
+        gfx::gfx_result sendRows(const gfx::rect16 &r, const uint8_t *first,
+                size_t stride, bool async) {
+            const uint16_t w = r.width();
+            const size_t size = (size_t)w * r.height() * sizeof(uint16_t);
+            if(w * sizeof(uint16_t) == stride && esp_ptr_dma_capable(first)
+                    && esp_ptr_dma_capable(first + size - 1)) {
+                gfx::gfx_result res = send(r, first, size, external);
+                if(res == gfx::gfx_result::success && !async) {
+                    drain();
+                }
+                return res;
+            }
+            const uint16_t rows = chunkRows(w);
+            for(uint16_t y = r.y1; y <= r.y2; y += rows) {
+                uint16_t y2 = y + rows - 1 < r.y2 ? y + rows - 1 : r.y2;
+                const int b = freeBuffer();
+                uint8_t *out = buffers[b];
+                for(uint16_t row = y; row <= y2; row++) {
+                    memcpy(out, first, w * sizeof(uint16_t));
+                    out += w * sizeof(uint16_t);
+                    first += stride;
+                }
+                gfx::gfx_result res = send(gfx::rect16(r.x1, y, r.x2, y2),
+                    buffers[b], out - buffers[b], b);
+                if(res != gfx::gfx_result::success) {
+                    return res;
+                }
+            }
+            return gfx::gfx_result::success;
+        }
+
+        // Init sequence of the ST7735R (red and green tab panels)
+        esp_err_t init() {
+            struct step {
+                uint8_t cmd;
+                uint8_t size;
+                uint8_t params[16];
+                uint16_t delayMs;
+            };
+            static const step steps[] = {
+                { ST7735_SWRESET, 0, {}, 150 },
+                { ST7735_SLPOUT, 0, {}, 120 },
+                { 0xB1, 3, { 0x01, 0x2C, 0x2D }, 0 },                           // FRMCTR1
+                { 0xB2, 3, { 0x01, 0x2C, 0x2D }, 0 },                           // FRMCTR2
+                { 0xB3, 6, { 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D }, 0 },         // FRMCTR3
+                { 0xB4, 1, { 0x07 }, 0 },                                       // INVCTR
+                { 0xC0, 3, { 0xA2, 0x02, 0x84 }, 0 },                           // PWCTR1
+                { 0xC1, 1, { 0xC5 }, 0 },                                       // PWCTR2
+                { 0xC2, 2, { 0x0A, 0x00 }, 0 },                                 // PWCTR3
+                { 0xC3, 2, { 0x8A, 0x2A }, 0 },                                 // PWCTR4
+                { 0xC4, 2, { 0x8A, 0xEE }, 0 },                                 // PWCTR5
+                { 0xC5, 1, { 0x0E }, 0 },                                       // VMCTR1
+                { 0x20, 0, {}, 0 },                                             // INVOFF
+                { ST7735_COLMOD, 1, { 0x05 }, 0 },                              // RGB565
+                { 0xE0, 16, { 0x02, 0x1C, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2D,
+                    0x29, 0x25, 0x2B, 0x39, 0x00, 0x01, 0x03, 0x10 }, 0 },      // GMCTRP1
+                { 0xE1, 16, { 0x03, 0x1D, 0x07, 0x06, 0x2E, 0x2C, 0x29, 0x2D,
+                    0x2E, 0x2E, 0x37, 0x3F, 0x00, 0x00, 0x02, 0x10 }, 0 },      // GMCTRN1
+                { 0x13, 0, {}, 10 },                                            // NORON
+                { ST7735_DISPON, 0, {}, 100 },
+            };
+            for(const step &s : steps) {
+                esp_err_t err = esp_lcd_panel_io_tx_param(io, s.cmd,
+                    s.size > 0 ? s.params : nullptr, s.size);
+                if(err != ESP_OK) {
+                    return err;
+                }
+                if(s.delayMs > 0) {
+                    vTaskDelay(pdMS_TO_TICKS(s.delayMs));
+                }
+            }
+
+            const uint8_t madctl = st7735_madctl(Rotation);
+            return esp_lcd_panel_io_tx_param(io, ST7735_MADCTL, &madctl, 1);
+        }
+};
+
+template<typename Lcd>
+struct is_esp_lcd : std::false_type {};
+
+template<uint16_t Width, uint16_t Height, spi_host_device_t Host,
+        gpio_num_t PinCS, gpio_num_t PinDC, gpio_num_t PinRst,
+        gpio_num_t PinBckl, uint8_t Rotation, size_t BufferSize>
+struct is_esp_lcd<esp_lcd_st7735<Width, Height, Host, PinCS, PinDC, PinRst,
+        PinBckl, Rotation, BufferSize>> : std::true_type {};
+
+} // namespace bcd_render
@@ -0,0 +1,82 @@
+/**
+ * @file    bcd_frame_clock.hpp
+ * @brief   Fixed rate frame pacing
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * The FreeRTOS tick runs at 100 Hz, too coarse to pace frames with
+ * vTaskDelay(). The frame clock uses a periodic esp_timer instead, which
+ * notifies the task that started it once per frame. wait() blocks until the
+ * next frame is due and returns the time of the frame, which drives the
+ * timelines (see bcd_timeline.hpp).
+ *
+ * If a frame takes longer than the period, the missed frames are dropped and
+ * the next wait() returns right away. dropped() counts them, which tells
+ * whether a screen loop fits its frame budget. busy() is the time the loop
+ * spent between two calls of wait(), the work of the last frame, which
+ * quality_governor (see bcd_quality.hpp) compares against the period.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "esp_timer.h"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+class frame_clock {
+    public:
+        frame_clock() = default;
+        frame_clock(const frame_clock &) = delete;
+        frame_clock &operator=(const frame_clock &) = delete;
+        ~frame_clock() { stop(); }
+
+        /**
+         * @brief Starts the clock. Only the calling task may call wait().
+         *
+         * @param fps Frames per second
+         * @return RENDER_OK on success, RENDER_FAIL if the timer could not
+         *      be created
+         */
+        render_err_t start(uint32_t fps = CONFIG_RENDER_FRAME_RATE);
+        void stop();
+        bool running() const { return timer != nullptr; }
+
+        /**
+         * @brief Blocks until the next frame is due
+         *
+         * Without a running clock, this returns immediately.
+         *
+         * @return Time of the frame in microseconds since boot
+         */
+        int64_t wait();
+
+        uint32_t period() const { return periodUs; }
+
+        /** Frames dropped because the loop took longer than the period */
+        uint32_t dropped() const { return droppedCount; }
+
+        /**
+         * @brief Microseconds the loop worked on the last frame
+         *
+         * The time from the return of one wait() to the call of the next.
+         * 0 before the second frame.
+         */
+        uint32_t busy() const { return busyUs; }
+
+    private:
+        esp_timer_handle_t timer = nullptr;
+        TaskHandle_t task = nullptr;
+        uint32_t periodUs = 0;
+        uint32_t droppedCount = 0;
+        int64_t frameStart = 0;                                                 /**< Return of the last wait() */
+        uint32_t busyUs = 0;
+
+        static void tick(void *arg);
+};
+
+} // namespace bcd_render
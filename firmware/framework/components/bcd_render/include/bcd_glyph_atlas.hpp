@@ -0,0 +1,184 @@
+/**
+ * @file    bcd_glyph_atlas.hpp
+ * @brief   Anti-aliased glyphs of a TrueType font, rasterised once
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * gfx renders TrueType fonts (gfx::open_font) by rasterising every glyph
+ * from its outlines on every call, far too slow to do each frame. The glyph
+ * atlas rasterises the printable ASCII glyphs of a font at one size when it
+ * is initialised and keeps them as 8 bit coverage masks. Drawing text then
+ * lays the text colour over the target through the masks (see
+ * bcd_render::blend_mask()), anti-aliased against whatever is below and
+ * without touching the font again.
+ *
+ * The masks are stored one after the other, every glyph as many rows as the
+ * line height and as wide as its advance, in PSRAM if there is any. The
+ * kerning of a pair of glyphs is taken from the font the first time the pair
+ * is laid out and kept in a table next to the masks, so layout only adds up
+ * cached advances. The font must stay valid as long as the atlas is used.
+ *
+ * Text is laid out like glyph_cache does it: left to right from the top left
+ * corner of the bounds, '\n' starts a new line, '\r' returns to the left
+ * edge, and a glyph that does not fit the line wraps. Characters outside of
+ * ' ' - '~' are drawn as '?'.
+ *
+ * Usage:
+ *      bcd_render::glyph_atlas hud;
+ *      hud.initialize(font, 12);
+ *      srect16 r = hud.measure_text((ssize16)lcd.dimensions(), "Score")
+ *          .bounds().offset(100, 10);
+ *      hud.draw(frame, r, "Score", color<pixel_type>::white);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+#include "bcd_blit.hpp"
+
+namespace bcd_render {
+
+class glyph_atlas {
+    public:
+        static constexpr uint8_t firstChar = ' ';
+        static constexpr uint8_t lastChar = '~';
+        static constexpr size_t glyphCount = lastChar - firstChar + 1;
+
+        glyph_atlas() = default;
+        glyph_atlas(const glyph_atlas &) = delete;
+        glyph_atlas &operator=(const glyph_atlas &) = delete;
+        ~glyph_atlas() { deinitialize(); }
+
+        /**
+         * @brief Rasterises the glyphs of a font
+         *
+         * Takes a few milliseconds per glyph, call it once at start up.
+         *
+         * @param font The font, must outlive the atlas
+         * @param pixelHeight Height of a line in pixels
+         * @return RENDER_OK on success, RENDER_ERR_NO_MEM if the masks do not
+         *      fit into memory, RENDER_ERR_DRAW if gfx cannot render the
+         *      font
+         */
+        render_err_t initialize(const gfx::open_font &font,
+            float pixelHeight);
+        void deinitialize();
+        bool initialized() const { return masks != nullptr; }
+
+        /**
+         * @brief Height of a line in pixels
+         */
+        uint16_t height() const { return lineHeight; }
+
+        /**
+         * @brief Horizontal adjustment between two glyphs in pixels
+         */
+        int16_t kerning(char left, char right);
+
+        /**
+         * @brief Size of a text laid out within an area, like
+         *      gfx::font::measure_text()
+         */
+        gfx::ssize16 measure_text(gfx::ssize16 area, const char *str);
+
+        /**
+         * @brief Draws text on any draw target
+         *
+         * Only the pixels covered by glyphs are touched. Targets that
+         * cannot be read back get no anti-aliasing (see bcd_blit.hpp).
+         */
+        template<typename Destination>
+        gfx::gfx_result draw(Destination &destination,
+                const gfx::srect16 &bounds, const char *str,
+                typename Destination::pixel_type color) {
+            gfx::srect16 screen = (gfx::srect16)destination.bounds();
+            if(masks == nullptr) {
+                return gfx::gfx_result::invalid_state;
+            }
+            if(!screen.intersects(bounds)) {
+                return gfx::gfx_result::success;
+            }
+            return layout(bounds, bounds.crop(screen), str,
+                [&](const gfx::srect16 &dst, const uint8_t *mask,
+                    uint16_t width) {
+                    return bcd_render::blend_mask(destination, dst, mask,
+                        width, color);
+                });
+        }
+
+        uint32_t hits() const { return hitCount; }                              /**< Pairs found in the kerning table */
+        uint32_t misses() const { return missCount; }                           /**< Pairs measured from the font */
+
+    private:
+        static constexpr int8_t unknown = INT8_MIN;                             /**< Kerning not measured yet */
+
+        struct glyph {
+            uint32_t offset;                                                    /**< First byte of the mask */
+            uint16_t width;                                                     /**< Advance and width of the mask */
+        };
+
+        const gfx::open_font *font = nullptr;
+        float scale = 0;
+        uint8_t *masks = nullptr;
+        int8_t *kerns = nullptr;                                                /**< glyphCount x glyphCount, in the same block as the masks */
+        uint16_t lineHeight = 0;
+        glyph glyphs[glyphCount];
+        uint32_t hitCount = 0;
+        uint32_t missCount = 0;
+
+        static size_t index(char ch) {
+            const uint8_t c = (uint8_t)ch;
+            return c < firstChar || c > lastChar ? '?' - firstChar
+                : c - firstChar;
+        }
+
+        // Walks the glyphs of a text and hands the visible part of every
+        // glyph to blend, as destination rectangle and first byte of its
+        // mask
+        template<typename Blend>
+        gfx::gfx_result layout(const gfx::srect16 &bounds,
+                const gfx::srect16 &clip, const char *str, Blend blend) {
+            const int16_t h = lineHeight;
+            int16_t x = bounds.left();
+            int16_t y = bounds.top();
+            char previous = '\0';
+            for(const char *p = str; *p != '\0' && y <= clip.bottom(); p++) {
+                if(*p == '\r' || *p == '\n') {
+                    x = bounds.left();
+                    y += *p == '\n' ? h : 0;
+                    previous = '\0';
+                    continue;
+                }
+                if(previous != '\0') {
+                    x += kerning(previous, *p);
+                }
+                previous = *p;
+                const glyph &g = glyphs[index(*p)];
+                if(x > bounds.left() && x + g.width - 1 > bounds.right()) {
+                    x = bounds.left();
+                    y += h;
+                    if(y > clip.bottom()) {
+                        break;
+                    }
+                }
+                gfx::srect16 cell(x, y, x + g.width - 1, y + h - 1);
+                if(g.width > 0 && cell.intersects(clip)) {
+                    gfx::srect16 dst = cell.crop(clip);
+                    gfx::gfx_result res = blend(dst, masks + g.offset
+                        + (dst.top() - y) * g.width + (dst.left() - x),
+                        g.width);
+                    if(res != gfx::gfx_result::success) {
+                        return res;
+                    }
+                }
+                x += g.width;
+            }
+            return gfx::gfx_result::success;
+        }
+};
+
+} // namespace bcd_render
@@ -0,0 +1,201 @@
+/**
+ * @file    bcd_glyph_cache.hpp
+ * @brief   Cache of pre-expanded bitmap font glyphs
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * The Bm437 fonts store every glyph as 1 bit rows, which draw::text unpacks
+ * pixel by pixel on every call. The glyph cache expands a glyph once for a
+ * foreground and background colour into an RGB565 tile. Drawing text then
+ * means copying the rows of the tiles, with no further per pixel work.
+ *
+ * Tiles live in one pool allocated by initialize(), a slot of
+ * maxGlyphWidth x maxGlyphHeight pixels per entry. That is enough for
+ * Bm437_Acer_VGA_8x8, Bm437_ACM_VGA_9x16 and Bm437_ATI_9x16. If all slots are
+ * taken, the least recently used glyph is expanded over. A screen uses only
+ * a few dozen distinct glyph and colour combinations, so the pool rarely
+ * runs full.
+ *
+ * Text is laid out like draw::text with an opaque background: left to right
+ * from the top left corner of the bounds, '\n' starts a new line, '\r'
+ * returns to the left edge, and a glyph that does not fit the line wraps.
+ *
+ * Usage:
+ *      bcd_render::glyph_cache glyphs;
+ *      glyphs.initialize();
+ *      glyphs.draw(lcd, text_rect, "Score", font, color<pixel_type>::white,
+ *          color<pixel_type>::black);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+#include "bcd_blit.hpp"
+
+namespace bcd_render {
+
+class glyph_cache {
+    public:
+        using pixel_type = gfx::rgb_pixel<16>;
+        using const_bitmap_type = gfx::const_bitmap<pixel_type>;
+
+        static constexpr uint16_t maxGlyphWidth = 16;
+        static constexpr uint16_t maxGlyphHeight = 16;
+        static constexpr size_t slotSize = maxGlyphWidth * maxGlyphHeight
+            * sizeof(uint16_t);
+
+        glyph_cache() { clear(); }
+        glyph_cache(const glyph_cache &) = delete;
+        glyph_cache &operator=(const glyph_cache &) = delete;
+        ~glyph_cache() { deinitialize(); }
+
+        /**
+         * @brief Allocates the tile pool, in internal RAM if possible
+         *
+         * @return RENDER_OK on success, RENDER_ERR_NO_MEM otherwise
+         */
+        render_err_t initialize();
+        void deinitialize();
+        bool initialized() const { return pool != nullptr; }
+
+        /**
+         * @brief Forgets all expanded glyphs
+         */
+        void clear();
+
+        /**
+         * @brief Returns the tile of a glyph, expanding it on a miss
+         *
+         * The tile has font.height() rows of width pixels in framebuffer
+         * byte order. It stays valid until the next get().
+         *
+         * @param width Receives the width of the glyph
+         * @return nullptr if the cache is not initialised or the glyph is
+         *      larger than a slot
+         */
+        const uint8_t *get(const gfx::font &font, char ch,
+            pixel_type foreground, pixel_type background, uint16_t *width);
+
+        /**
+         * @brief Draws text into an RGB565 framebuffer
+         *
+         * @param buffer Framebuffer in framebuffer byte order
+         * @param dimensions Size of the framebuffer
+         * @return gfx_result::invalid_argument if a glyph cannot be cached,
+         *      the text is then only partly drawn
+         */
+        gfx::gfx_result draw(uint8_t *buffer, gfx::size16 dimensions,
+            const gfx::srect16 &bounds, const char *str,
+            const gfx::font &font, pixel_type foreground,
+            pixel_type background);
+
+        /**
+         * @brief Draws text on any draw target, one blit per glyph (see
+         *      bcd_blit.hpp)
+         */
+        template<typename Destination>
+        gfx::gfx_result draw(Destination &destination,
+                const gfx::srect16 &bounds, const char *str,
+                const gfx::font &font, pixel_type foreground,
+                pixel_type background) {
+            gfx::srect16 screen = (gfx::srect16)destination.bounds();
+            if(!screen.intersects(bounds)) {
+                return gfx::gfx_result::success;
+            }
+            return layout(bounds, bounds.crop(screen), str, font, foreground,
+                background, [&](const gfx::srect16 &dst, const uint8_t *tile,
+                    uint16_t width, const gfx::rect16 &src) {
+                    return bcd_render::blit(destination, dst,
+                        const_bitmap_type(gfx::size16(width, font.height()),
+                            tile), src);
+                });
+        }
+
+        uint32_t hits() const { return hitCount; }
+        uint32_t misses() const { return missCount; }
+
+    private:
+        static constexpr size_t bucketCount = 64;
+        static constexpr int16_t none = -1;
+
+        struct entry {
+            const gfx::font *font = nullptr;                                    /**< nullptr if the slot is free */
+            uint16_t foreground;
+            uint16_t background;
+            uint8_t ch;
+            uint8_t width;
+            int16_t next;                                                       /**< Next entry of the bucket */
+            uint32_t lastUse;
+        };
+
+        uint8_t *pool = nullptr;
+        entry entries[CONFIG_RENDER_GLYPH_CACHE_ENTRIES];
+        int16_t buckets[bucketCount];
+        uint32_t clock = 0;
+        uint32_t hitCount = 0;
+        uint32_t missCount = 0;
+
+        static size_t bucket(const gfx::font *font, uint8_t ch,
+                uint16_t foreground, uint16_t background) {
+            return (((uintptr_t)font >> 2) ^ ch ^ (foreground * 31)
+                ^ (background * 7)) % bucketCount;
+        }
+
+        int16_t evict();
+        void expand(const gfx::font &font, uint8_t ch, uint16_t foreground,
+            uint16_t background, uint8_t *tile, uint16_t width);
+
+        // Walks the glyphs of a text and hands every visible part of a glyph
+        // to blit, as destination rectangle and rectangle within the tile
+        template<typename Blit>
+        gfx::gfx_result layout(const gfx::srect16 &bounds,
+                const gfx::srect16 &clip, const char *str,
+                const gfx::font &font, pixel_type foreground,
+                pixel_type background, Blit blit) {
+            const int16_t height = font.height();
+            int16_t x = bounds.left();
+            int16_t y = bounds.top();
+            for(const char *p = str; *p != '\0' && y <= clip.bottom(); p++) {
+                if(*p == '\r') {
+                    x = bounds.left();
+                    continue;
+                }
+                if(*p == '\n') {
+                    x = bounds.left();
+                    y += height;
+                    continue;
+                }
+                uint16_t width;
+                const uint8_t *tile = get(font, *p, foreground, background,
+                    &width);
+                if(tile == nullptr) {
+                    return gfx::gfx_result::invalid_argument;
+                }
+                if(x > bounds.left() && x + width - 1 > bounds.right()) {
+                    x = bounds.left();
+                    y += height;
+                    if(y > clip.bottom()) {
+                        break;
+                    }
+                }
+                gfx::srect16 cell(x, y, x + width - 1, y + height - 1);
+                if(cell.intersects(clip)) {
+                    gfx::srect16 dst = cell.crop(clip);
+                    gfx::rect16 src(dst.left() - x, dst.top() - y,
+                        dst.right() - x, dst.bottom() - y);
+                    gfx::gfx_result res = blit(dst, tile, width, src);
+                    if(res != gfx::gfx_result::success) {
+                        return res;
+                    }
+                }
+                x += width;
+            }
+            return gfx::gfx_result::success;
+        }
+};
+
+} // namespace bcd_render
@@ -0,0 +1,106 @@
+/**
+ * @file    bcd_image_cache.hpp
+ * @brief   Cache of decoded images
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Showing a JPEG from SPIFFS means reading the file from flash and running
+ * the IDCT for every block, each time the screen is shown. The image cache
+ * keeps the decoded RGB565 pixels in PSRAM instead, so showing the image
+ * again is a single bitmap blit. Files ending in .q16 are decoded with
+ * q16_image, all others as JPEG.
+ *
+ * Entries are keyed by path and modification time, so a file replaced on
+ * the filesystem is decoded again. If an image does not fit, the least
+ * recently used entries are dropped until it does. Images larger than the
+ * whole cache are not cached at all.
+ *
+ * Usage:
+ *      bcd_render::image_cache cache;
+ *      const bcd_render::image_cache::bitmap_type *image;
+ *      if(cache.get("/spiffs/start_screen.jpeg", &image) == RENDER_OK) {
+ *          draw::bitmap(lcd, (srect16)image->bounds(), *image,
+ *              image->bounds());
+ *      }
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <new>
+#include "esp_heap_caps.h"
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+class image_cache {
+    public:
+        using bitmap_type = gfx::bitmap<gfx::rgb_pixel<16>>;
+
+        static constexpr size_t pathLength = 48;
+
+        /**
+         * @param capacity Maximum number of bytes of decoded pixels
+         */
+        image_cache(size_t capacity = CONFIG_RENDER_IMAGE_CACHE_KB * 1024UL)
+            : capacity(capacity) {}
+        image_cache(const image_cache &) = delete;
+        image_cache &operator=(const image_cache &) = delete;
+        ~image_cache() { clear(); }
+
+        /**
+         * @brief Returns the decoded image of a JPEG or q16 file
+         *
+         * Decodes the file on a miss. The image stays valid until a later
+         * get() misses or the cache is cleared, so an image recorded in a
+         * display list must be flushed before the next image is loaded.
+         *
+         * @param path Path of the image file
+         * @param image Receives the decoded image
+         * @return RENDER_OK on success, RENDER_ERR_NOT_FOUND if the file
+         *      cannot be opened, RENDER_ERR_NO_MEM if the image does not fit
+         *      in the cache, RENDER_ERR_NOT_SUPPORTED if the path is too long
+         *      and RENDER_ERR_DRAW if decoding failed. On errors the caller
+         *      can still stream the file to the display.
+         */
+        render_err_t get(const char *path, const bitmap_type **image);
+
+        /**
+         * @brief Drops the entry of a file, if any
+         */
+        void evict(const char *path);
+        void clear();
+
+        size_t used() const { return bytes; }
+        uint32_t hits() const { return hitCount; }
+        uint32_t misses() const { return missCount; }
+
+    private:
+        struct entry {
+            char path[pathLength];
+            time_t mtime;
+            uint32_t lastUse;
+            size_t size;
+            uint8_t *pixels = nullptr;
+            bitmap_type *image;
+            alignas(bitmap_type) uint8_t imageStorage[sizeof(bitmap_type)];
+        };
+
+        const size_t capacity;
+        size_t bytes = 0;
+        uint32_t clock = 0;
+        uint32_t hitCount = 0;
+        uint32_t missCount = 0;
+        entry entries[CONFIG_RENDER_IMAGE_CACHE_ENTRIES];
+
+        entry *find(const char *path);
+        void drop(entry &e);
+        entry *reserve(size_t size);
+        render_err_t decode(const char *path, entry *&slot);
+};
+
+} // namespace bcd_render
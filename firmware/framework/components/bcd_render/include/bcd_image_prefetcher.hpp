@@ -0,0 +1,132 @@
+/**
+ * @file    bcd_image_prefetcher.hpp
+ * @brief   Decodes the next image on the other core
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * A slideshow that decodes every image when it is due stalls the UI task for
+ * the whole decode and leaves the other core idle. The prefetcher runs the
+ * decoder in its own task on the other core instead. While the current image
+ * is shown from the front buffer, the next one is decoded into a back buffer
+ * in PSRAM. take() swaps the two, so showing the next image is a single
+ * blit. Files ending in .q16 are decoded with q16_image, all others as JPEG.
+ *
+ * Both buffers are kept between images and only grow, so a series of images
+ * of the same size allocates twice.
+ *
+ * Only one task may call prefetch() and take().
+ *
+ * Usage:
+ *      bcd_render::image_prefetcher prefetcher;
+ *      prefetcher.initialize();
+ *      prefetcher.prefetch("/spiffs/logo_2k13.jpeg");
+ *      const bcd_render::image_prefetcher::bitmap_type *image;
+ *      if(prefetcher.take(&image) == RENDER_OK) {
+ *          prefetcher.prefetch("/spiffs/logo_2k14.jpeg");
+ *          draw::bitmap(lcd, (srect16)image->bounds(), *image,
+ *              image->bounds());
+ *      }
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+class image_prefetcher {
+    public:
+        using bitmap_type = gfx::bitmap<gfx::rgb_pixel<16>>;
+
+        static constexpr size_t pathLength = 48;
+
+        image_prefetcher() = default;
+        image_prefetcher(const image_prefetcher &) = delete;
+        image_prefetcher &operator=(const image_prefetcher &) = delete;
+        ~image_prefetcher() { deinitialize(); }
+
+        /**
+         * @brief Starts the decoder task on the core the caller does not
+         *      run on
+         *
+         * @return RENDER_OK on success, RENDER_ERR_NO_MEM if the task cannot
+         *      be created
+         */
+        render_err_t initialize();
+
+        /**
+         * @brief Stops the decoder task and frees both buffers
+         *
+         * Waits for a running decode to finish.
+         */
+        void deinitialize();
+
+        bool initialized() const { return task != nullptr; }
+
+        /**
+         * @brief Starts decoding an image into the back buffer
+         *
+         * Returns right away. If an earlier image was prefetched but not
+         * taken yet, its decode is finished first and the image dropped.
+         *
+         * @return RENDER_OK if the decode was started,
+         *      RENDER_ERR_NOT_INITIALIZED without decoder task and
+         *      RENDER_ERR_NOT_SUPPORTED if the path is too long
+         */
+        render_err_t prefetch(const char *path);
+
+        /**
+         * @brief Waits for the prefetched image and swaps it to the front
+         *
+         * The image stays valid until the next take().
+         *
+         * @param image Receives the decoded image
+         * @param timeout Ticks to wait for the decode to finish
+         * @return RENDER_OK on success, RENDER_FAIL if nothing was
+         *      prefetched, RENDER_ERR_TIMEOUT if the decode is still running
+         *      (take() can be called again), RENDER_ERR_NOT_FOUND if the file
+         *      cannot be opened, RENDER_ERR_NO_MEM if the back buffer cannot
+         *      be allocated and RENDER_ERR_DRAW if decoding failed
+         */
+        render_err_t take(const bitmap_type **image,
+            TickType_t timeout = portMAX_DELAY);
+
+        /**
+         * @brief Returns true if a prefetched image is ready to be taken
+         */
+        bool ready() const { return pending && !busy; }
+
+    private:
+        struct buffer {
+            uint8_t *pixels = nullptr;
+            size_t size = 0;
+            bitmap_type *image = nullptr;
+            alignas(bitmap_type) uint8_t imageStorage[sizeof(bitmap_type)];
+        };
+
+        TaskHandle_t task = nullptr;
+        SemaphoreHandle_t request = nullptr;                                    /**< Given to start a decode */
+        SemaphoreHandle_t done = nullptr;                                       /**< Given when a decode finished */
+        char path[pathLength];
+        volatile bool busy = false;                                             /**< Decoder task is working */
+        volatile bool stop = false;                                             /**< Decoder task should exit */
+        bool pending = false;                                                   /**< A decode was started, not taken */
+        render_err_t result = RENDER_OK;
+        buffer buffers[2];
+        buffer *front = &buffers[0];
+        buffer *back = &buffers[1];
+
+        static void run(void *arg);
+        render_err_t decode();
+        void release(buffer &b);
+};
+
+} // namespace bcd_render
@@ -0,0 +1,192 @@
+/**
+ * @file    bcd_indexed_surface.hpp
+ * @brief   4 bit indexed drawing surface
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Screens made of a handful of colours, like the playfield, do not need a
+ * full RGB565 buffer. An indexed surface stores two pixels per byte, a quarter
+ * of the memory. It is drawn through a display list, which expands it to
+ * RGB565 through a palette while copying it into the shadow framebuffer.
+ *
+ * tile() and tile_outline() draw the squares of a grid, like the cells of
+ * the board. Their size is a template parameter, the stores of a tile are
+ * generated at compile time with no loops or clipping left.
+ *
+ * Usage:
+ *      bcd_render::indexed_surface field;
+ *      bcd_render::indexed_palette palette;
+ *      field.initialize(size16(50, 110));
+ *      palette.set(1, color<pixel_type>::red);
+ *      field.fill(rect16(0, 0, 4, 4), 1);
+ *      dl.indexed(rect16(55, 10, 59, 14), field, rect16(0, 0, 4, 4), palette);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include "esp_heap_caps.h"
+#include "gfx_positioning.hpp"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+/**
+ * @brief Maps the 16 indices to RGB565 pixels
+ *
+ * The pixels are kept in the byte order of the framebuffer (high byte
+ * first), so expanding a pixel is a single 16 bit store.
+ */
+class indexed_palette {
+    public:
+        static constexpr size_t colors = 16;
+
+        template<typename Pixel>
+        void set(uint8_t index, Pixel color) {
+            static_assert(Pixel::bit_depth == 16, "Palette holds RGB565");
+            uint16_t v = color.native_value;
+            uint8_t *p = (uint8_t *)&lut[index & (colors - 1)];
+            p[0] = v >> 8;
+            p[1] = v & 0xff;
+        }
+
+        uint16_t operator[](uint8_t index) const { return lut[index]; }
+
+    private:
+        uint16_t lut[colors] = { 0 };
+};
+
+class indexed_surface {
+    public:
+        indexed_surface() = default;
+        indexed_surface(const indexed_surface &) = delete;
+        indexed_surface &operator=(const indexed_surface &) = delete;
+        ~indexed_surface() { deinitialize(); }
+
+        /**
+         * @brief Allocates the surface in internal memory and fills it with
+         *      index 0
+         */
+        render_err_t initialize(const gfx::size16 &dimensions);
+        void deinitialize();
+        bool initialized() const { return pixels != nullptr; }
+
+        gfx::size16 dimensions() const { return size; }
+        gfx::rect16 bounds() const {
+            return gfx::rect16(gfx::point16(0, 0), size);
+        }
+
+        void fill(const gfx::rect16 &r, uint8_t index);
+
+        /**
+         * @brief Draws the one pixel wide outline of a rectangle
+         */
+        void rectangle(const gfx::rect16 &r, uint8_t index);
+
+        /**
+         * @brief Fills a square of Size pixels
+         *
+         * Does not clip, the square must be inside the surface.
+         *
+         * @param x, y Top left corner of the square
+         */
+        template<uint16_t Size>
+        void tile(uint16_t x, uint16_t y, uint8_t index) {
+            uint8_t *first = pixels + y * stride + x / 2;
+            if(x & 1) {
+                tileRows<Size, true>(first, index & 0x0f,
+                    std::make_index_sequence<Size>());
+            } else {
+                tileRows<Size, false>(first, index & 0x0f,
+                    std::make_index_sequence<Size>());
+            }
+        }
+
+        /**
+         * @brief Draws the one pixel wide outline of a square of Size pixels
+         *
+         * Does not clip, the square must be inside the surface.
+         */
+        template<uint16_t Size>
+        void tile_outline(uint16_t x, uint16_t y, uint8_t index) {
+            static_assert(Size >= 2, "Outlines need two rows");
+            uint8_t *first = pixels + y * stride + x / 2;
+            uint8_t *last = first + (Size - 1) * stride;
+            if(x & 1) {
+                tileRow<Size, true>(first, index & 0x0f);
+                tileRow<Size, true>(last, index & 0x0f);
+            } else {
+                tileRow<Size, false>(first, index & 0x0f);
+                tileRow<Size, false>(last, index & 0x0f);
+            }
+            for(uint16_t r = y + 1; r < y + Size - 1; r++) {
+                set(x, r, index);
+                set(x + Size - 1, r, index);
+            }
+        }
+
+        uint8_t point(uint16_t x, uint16_t y) const {
+            uint8_t b = pixels[y * stride + x / 2];
+            return x & 1 ? b & 0x0f : b >> 4;
+        }
+
+        /**
+         * @brief Expands part of a row to RGB565
+         *
+         * @param x First pixel of the row to expand
+         * @param y The row
+         * @param width Number of pixels to expand
+         * @param palette Palette to expand with
+         * @param out Receives width pixels, high byte first. Must be 2 byte
+         *      aligned.
+         */
+        void expand(uint16_t x, uint16_t y, uint16_t width,
+            const indexed_palette &palette, uint8_t *out) const;
+
+    private:
+        uint8_t *pixels = nullptr;
+        gfx::size16 size { 0, 0 };
+        size_t stride = 0;
+
+        void set(uint16_t x, uint16_t y, uint8_t index) {
+            uint8_t *b = pixels + y * stride + x / 2;
+            *b = x & 1 ? (*b & 0xf0) | (index & 0x0f)
+                : (*b & 0x0f) | (index << 4);
+        }
+
+        template<uint16_t Size, bool Odd, size_t... Row>
+        void tileRows(uint8_t *first, uint8_t index,
+                std::index_sequence<Row...>) {
+            (tileRow<Size, Odd>(first + Row * stride, index), ...);
+        }
+
+        // A row of a tile starting on the low nibble (Odd) or the high
+        // nibble of its first byte: a leading nibble, whole bytes and a
+        // trailing nibble
+        template<uint16_t Size, bool Odd>
+        static void tileRow(uint8_t *p, uint8_t index) {
+            constexpr uint16_t bytes = (Size - Odd) / 2;
+            if constexpr(Odd) {
+                *p = (*p & 0xf0) | index;
+                p++;
+            }
+            if constexpr(bytes > 0) {
+                storeBytes(p, (index << 4) | index,
+                    std::make_index_sequence<bytes>());
+            }
+            if constexpr((Size - Odd) & 1) {
+                p[bytes] = (p[bytes] & 0x0f) | (index << 4);
+            }
+        }
+
+        template<size_t... Byte>
+        static void storeBytes(uint8_t *p, uint8_t both,
+                std::index_sequence<Byte...>) {
+            ((p[Byte] = both), ...);
+        }
+};
+
+} // namespace bcd_render
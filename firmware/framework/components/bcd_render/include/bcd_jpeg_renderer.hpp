@@ -0,0 +1,210 @@
+/**
+ * @file    bcd_jpeg_renderer.hpp
+ * @brief   Streaming JPEG renderer with full width strips
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * jpeg_image::load() hands out the image one MCU (8x8 or 16x16 pixels) at a
+ * time. Drawing every MCU on its own costs an address window and an SPI
+ * transaction per block. The renderer copies the MCUs of a row into a full
+ * width strip in DMA capable memory instead and sends the strip as one
+ * window once the decoder moves on to the next row.
+ *
+ * Files with the .q16 extension are decoded with q16_image (see
+ * bcd_q16.hpp). That decoder already hands out full width strips, which are
+ * sent without copying.
+ *
+ * The destination can be the display or a framebuffer, like the shadow of a
+ * display list (see display_list::compose()). Strips are drawn with
+ * bcd_render::blit(), so framebuffers get a row copy per strip.
+ *
+ * The position of the image and the strip travel through the state pointer
+ * of the decoder callback, nothing is kept in globals. A renderer owns its
+ * strip buffer though, so one renderer draws one image at a time.
+ *
+ * Usage:
+ *      bcd_render::jpeg_renderer<lcd_type> jpeg(lcd);
+ *      jpeg.draw("/spiffs/start_screen.jpeg", spoint16(0, 0));
+ */
+#pragma once
+
+#include <string.h>
+#include <new>
+#include "esp_heap_caps.h"
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+#include "bcd_q16.hpp"
+#include "bcd_blit.hpp"
+
+namespace bcd_render {
+
+template<typename Destination>
+class jpeg_renderer {
+    public:
+        using pixel_type = typename Destination::pixel_type;
+        using bitmap_type = gfx::bitmap<pixel_type>;
+        using region_type = typename gfx::jpeg_image::region_type;
+
+        static_assert(pixel_type::bit_depth == 16, "Strips hold RGB565");
+
+        /** Highest MCU of a JPEG, 4:2:0 subsampling */
+        static constexpr uint16_t maxStripHeight = 16;
+
+        jpeg_renderer(Destination &destination) : destination(destination) {}
+        jpeg_renderer(const jpeg_renderer &) = delete;
+        jpeg_renderer &operator=(const jpeg_renderer &) = delete;
+        ~jpeg_renderer() { deinitialize(); }
+
+        /**
+         * @brief Frees the strip buffer. It is allocated again by the next
+         *      draw().
+         */
+        void deinitialize() {
+            if(buffer != nullptr) {
+                heap_caps_free(buffer);
+                buffer = nullptr;
+                bufferWidth = 0;
+            }
+        }
+
+        /**
+         * @brief Decodes a JPEG or q16 file onto the destination
+         *
+         * @return RENDER_OK on success, RENDER_ERR_NOT_FOUND if the file
+         *      cannot be opened and RENDER_ERR_DRAW if decoding or drawing
+         *      failed.
+         */
+        render_err_t draw(const char *path, const gfx::spoint16 &location) {
+            gfx::file_stream fs(path);
+            if(!fs.caps().read) {
+                ESP_LOGE(TAG_RENDER, "Cannot open %s.", path);
+                return RENDER_ERR_NOT_FOUND;
+            }
+            render_err_t err = draw(&fs, location, q16_image::matches(path));
+            fs.close();
+            return err;
+        }
+
+        render_err_t draw(gfx::stream *in, const gfx::spoint16 &location,
+                bool q16 = false) {
+            state_t state;
+            state.renderer = this;
+            state.location = location;
+            gfx::gfx_result res = q16
+                ? q16_image::load(in, &region, &state)
+                : gfx::jpeg_image::load(in, &region, &state);
+            if(res == gfx::gfx_result::success) {
+                res = flushStrip(state);
+            }
+            if(res != gfx::gfx_result::success) {
+                ESP_LOGE(TAG_RENDER, "Drawing image failed (%d).", (int)res);
+                return RENDER_ERR_DRAW;
+            }
+            return RENDER_OK;
+        }
+
+        /**
+         * @brief Number of strips sent by all draw() calls
+         */
+        uint32_t strips() const { return stripCount; }
+
+    private:
+        struct state_t {
+            jpeg_renderer *renderer;
+            gfx::spoint16 location;                                             /**< Top left corner of the image */
+            uint16_t stripTop = 0;                                              /**< Image row of the strip */
+            uint16_t stripWidth = 0;                                            /**< Pixels per strip row */
+            uint16_t stripHeight = 0;                                           /**< Rows in the strip, 0 if empty */
+            bitmap_type *strip = nullptr;                                       /**< nullptr without strip buffer */
+            alignas(bitmap_type) uint8_t stripStorage[sizeof(bitmap_type)];
+        };
+
+        Destination &destination;
+        uint8_t *buffer = nullptr;
+        uint16_t bufferWidth = 0;
+        uint32_t stripCount = 0;
+
+        // Strip buffers are only kept at the largest width seen, so drawing
+        // several images of the same size allocates once
+        bool reserve(uint16_t width) {
+            if(buffer != nullptr && width <= bufferWidth) {
+                return true;
+            }
+            deinitialize();
+            buffer = (uint8_t *)heap_caps_malloc(bitmap_type::sizeof_buffer(
+                gfx::size16(width, maxStripHeight)), MALLOC_CAP_DMA);
+            if(buffer == nullptr) {
+                ESP_LOGW(TAG_RENDER, "No memory for a %u px JPEG strip. "
+                    "Drawing block by block.", width);
+                return false;
+            }
+            bufferWidth = width;
+            return true;
+        }
+
+        gfx::gfx_result flushStrip(state_t &s) {
+            if(s.strip == nullptr || s.stripHeight == 0) {
+                return gfx::gfx_result::success;
+            }
+            stripCount++;
+            uint16_t height = s.stripHeight;
+            s.stripHeight = 0;
+            return bcd_render::blit(destination, gfx::srect16(
+                s.location.x, s.location.y + s.stripTop,
+                s.location.x + s.stripWidth - 1,
+                s.location.y + s.stripTop + height - 1), *s.strip,
+                gfx::rect16(0, 0, s.stripWidth - 1, height - 1));
+        }
+
+        static gfx::gfx_result region(gfx::size16 dimensions,
+                region_type &region, gfx::point16 location, void *arg) {
+            state_t &s = *(state_t *)arg;
+            jpeg_renderer &r = *s.renderer;
+            gfx::size16 size = region.dimensions();
+
+            if(s.strip == nullptr && location.x == 0 && location.y == 0
+                    && size.width < dimensions.width
+                    && r.reserve(dimensions.width)) {
+                s.stripWidth = dimensions.width;
+                s.strip = new (&s.stripStorage) bitmap_type(
+                    gfx::size16(dimensions.width, maxStripHeight), r.buffer);
+            }
+            if(s.strip == nullptr || size.height > maxStripHeight
+                    || size.width == dimensions.width) {
+                // Nothing to coalesce, or already a full strip
+                gfx::gfx_result res = r.flushStrip(s);
+                if(res != gfx::gfx_result::success) {
+                    return res;
+                }
+                return bcd_render::blit(r.destination, gfx::srect16(
+                    (gfx::spoint16)location, (gfx::ssize16)size).offset(
+                    s.location.x, s.location.y), region, region.bounds());
+            }
+
+            // The decoder moved on to the next row of MCUs
+            if(s.stripHeight != 0 && location.y != s.stripTop) {
+                gfx::gfx_result res = r.flushStrip(s);
+                if(res != gfx::gfx_result::success) {
+                    return res;
+                }
+            }
+            s.stripTop = location.y;
+            s.stripHeight = size.height;
+
+            // Both are RGB565 in framebuffer byte order, so rows are copied
+            const size_t rowBytes = size.width * sizeof(uint16_t);
+            const size_t stride = s.stripWidth * sizeof(uint16_t);
+            const uint8_t *src = region.begin();
+            uint8_t *dst = r.buffer + location.x * sizeof(uint16_t);
+            for(uint16_t y = 0; y < size.height; y++) {
+                memcpy(dst, src, rowBytes);
+                src += rowBytes;
+                dst += stride;
+            }
+            return gfx::gfx_result::success;
+        }
+};
+
+} // namespace bcd_render
@@ -0,0 +1,173 @@
+/**
+ * @file    bcd_orientation.hpp
+ * @brief   Screen layout on top of the panel's native orientation
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * The ST7735 is mounted rotated. Its drivers turn the picture with the
+ * MADCTL register, which makes the controller fill its memory column by
+ * column for rotations 1 and 3. A frame kept in the panel's native scan
+ * order is written row by row instead, and an area spanning whole panel
+ * lines is a single contiguous block of memory.
+ *
+ * orientation<Rotation> maps screen (layout) coordinates to native panel
+ * coordinates. The rotation is a template parameter, so the mapping is
+ * selected at compile time and reduces to a few additions per call. The
+ * rotations are the ones of the drivers (and of MADCTL, see
+ * st7735_madctl()): rotation 1 turns the picture by 90 degrees clockwise,
+ * every further step by another 90 degrees.
+ *
+ * rotated_view wraps a bitmap in native orientation into a gfx draw target
+ * in layout coordinates, so everything gfx draws lands in the right place.
+ * bcd_blit.hpp has kernels that fill, blend and blit it without going
+ * through single pixels.
+ *
+ * Usage:
+ *      using layout = bcd_render::orientation<3>;
+ *      // Panel memory position of screen pixel (10, 20) on a 128x160 panel
+ *      gfx::spoint16 p = layout::point(gfx::spoint16(10, 20),
+ *          gfx::size16(128, 160));
+ *      bcd_render::rotated_view<gfx::bitmap<pixel_type>, 3> screen(native);
+ *      gfx::draw::text(screen, rect, "Score", font, color<pixel_type>::white);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gfx.hpp"
+
+namespace bcd_render {
+
+template<uint8_t Rotation>
+struct orientation {
+    static_assert(Rotation < 4, "Rotations are 0 - 3");
+
+    /** Rows of the layout are columns of the panel */
+    static constexpr bool swapped = Rotation & 1;
+
+    /**
+     * @brief Size of the layout (or of the panel, the mapping is symmetric)
+     */
+    static gfx::size16 layout(const gfx::size16 &native) {
+        return swapped ? gfx::size16(native.height, native.width) : native;
+    }
+
+    /**
+     * @brief Native position of a layout point
+     *
+     * @param native Size of the panel in its native orientation
+     */
+    static gfx::spoint16 point(const gfx::spoint16 &p,
+            const gfx::size16 &native) {
+        if constexpr(Rotation == 1) {
+            return gfx::spoint16(native.width - 1 - p.y, p.x);
+        } else if constexpr(Rotation == 2) {
+            return gfx::spoint16(native.width - 1 - p.x,
+                native.height - 1 - p.y);
+        } else if constexpr(Rotation == 3) {
+            return gfx::spoint16(p.y, native.height - 1 - p.x);
+        } else {
+            return p;
+        }
+    }
+
+    /**
+     * @brief Native area of a layout rectangle, normalised
+     */
+    static gfx::srect16 rect(const gfx::srect16 &r,
+            const gfx::size16 &native) {
+        const gfx::spoint16 a = point(gfx::spoint16(r.x1, r.y1), native);
+        const gfx::spoint16 b = point(gfx::spoint16(r.x2, r.y2), native);
+        return gfx::srect16(a.x, a.y, b.x, b.y).normalize();
+    }
+
+    /**
+     * @brief Byte offset in native memory of one layout pixel to the right
+     *
+     * @param stride Bytes per native row
+     * @param bytes Bytes per pixel
+     */
+    static constexpr ptrdiff_t stepX(size_t stride, size_t bytes) {
+        return Rotation == 1 ? (ptrdiff_t)stride
+            : Rotation == 2 ? -(ptrdiff_t)bytes
+            : Rotation == 3 ? -(ptrdiff_t)stride
+            : (ptrdiff_t)bytes;
+    }
+
+    /**
+     * @brief Byte offset in native memory of one layout pixel down
+     */
+    static constexpr ptrdiff_t stepY(size_t stride, size_t bytes) {
+        return Rotation == 1 ? -(ptrdiff_t)bytes
+            : Rotation == 2 ? -(ptrdiff_t)stride
+            : Rotation == 3 ? (ptrdiff_t)bytes
+            : (ptrdiff_t)stride;
+    }
+};
+
+/**
+ * @brief A bitmap in native panel orientation, drawn in layout coordinates
+ *
+ * Does not own the bitmap, which must outlive the view.
+ */
+template<typename Bitmap, uint8_t Rotation>
+class rotated_view {
+    public:
+        using pixel_type = typename Bitmap::pixel_type;
+        using caps = gfx::gfx_caps<false, false, false, false, false, true,
+            false>;
+        using transform = orientation<Rotation>;
+
+        rotated_view(Bitmap &native) : target(&native) {}
+
+        /**
+         * @brief The bitmap in native orientation
+         */
+        Bitmap &native() const { return *target; }
+
+        gfx::size16 dimensions() const {
+            return transform::layout(target->dimensions());
+        }
+        gfx::rect16 bounds() const { return dimensions().bounds(); }
+
+        gfx::gfx_result point(gfx::point16 location, pixel_type color) {
+            if(!contains(location)) {
+                return gfx::gfx_result::success;
+            }
+            return target->point(map(location), color);
+        }
+
+        gfx::gfx_result point(gfx::point16 location, pixel_type *color) const {
+            if(!contains(location)) {
+                return gfx::gfx_result::invalid_argument;
+            }
+            return target->point(map(location), color);
+        }
+
+        gfx::gfx_result fill(const gfx::rect16 &r, pixel_type color) {
+            return target->fill((gfx::rect16)transform::rect(
+                (gfx::srect16)r.crop(bounds()), target->dimensions()), color);
+        }
+
+        gfx::gfx_result clear(const gfx::rect16 &r) {
+            return target->clear((gfx::rect16)transform::rect(
+                (gfx::srect16)r.crop(bounds()), target->dimensions()));
+        }
+
+    private:
+        Bitmap *target;
+
+        bool contains(gfx::point16 location) const {
+            const gfx::size16 d = dimensions();
+            return location.x < d.width && location.y < d.height;
+        }
+
+        gfx::point16 map(gfx::point16 location) const {
+            return (gfx::point16)transform::point((gfx::spoint16)location,
+                target->dimensions());
+        }
+};
+
+} // namespace bcd_render
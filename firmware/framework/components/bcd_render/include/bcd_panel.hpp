@@ -0,0 +1,230 @@
+/**
+ * @file    bcd_panel.hpp
+ * @brief   Direct access to the display controller
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * The gfx draw target interface only knows about pixels. Some features of the
+ * ST7735 controller, such as hardware scrolling, need raw commands. panel_io
+ * sends them through the command interface of the display driver, so they
+ * are serialised with the driver's own transactions on the SPI bus. That is
+ * send_command()/send_data() for espidf::st7735 and the esp_lcd panel IO for
+ * esp_lcd_st7735.
+ *
+ * Commands must only be sent while the driver has no open batch, eg. after a
+ * display list flush.
+ *
+ * scan_order() and write() let a display list send a frame it keeps in the
+ * panel's native orientation: the controller is switched to rotation 0, the
+ * windows are written with their rows as they are in memory, and the
+ * driver's rotation is restored afterwards. MADCTL only changes how memory
+ * is addressed, not what the panel shows, so switching it is invisible.
+ *
+ * pixel_format() and write_rgb444() use the 12 bit interface mode of the
+ * controller (COLMOD 0x03), which takes two pixels in three bytes. Areas
+ * that only show a few colours, like the playfield, go out with a quarter
+ * fewer bytes. The mode stays set until it is switched back, drivers and
+ * write() must only be used in 16 bit mode.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "st7735_bcd.hpp"
+#include "bcd_render.hpp"
+#include "bcd_esp_lcd.hpp"
+#include "bcd_rgb565.hpp"
+
+// ST7735 commands that are not used by the gfx driver
+#define ST7735_NORON    0x13                                                    /**< Normal display mode on */
+#define ST7735_VSCRDEF  0x33                                                    /**< Vertical scrolling definition */
+#define ST7735_VSCSAD   0x37                                                    /**< Vertical scroll start address */
+
+// Interface pixel formats of COLMOD
+#define ST7735_COLMOD_12BIT 0x03                                                /**< RGB444, 2 pixels in 3 bytes */
+#define ST7735_COLMOD_16BIT 0x05                                                /**< RGB565 */
+
+namespace bcd_render {
+
+template<typename Lcd>
+struct panel_io {
+    /** Largest block of pixel data written in one transaction */
+    static constexpr size_t chunk = 4096;
+
+    /**
+     * @brief Sends a command with optional parameter bytes
+     */
+    static render_err_t command(Lcd &lcd, uint8_t cmd,
+            const uint8_t *params = nullptr, size_t size = 0) {
+        if constexpr(is_esp_lcd<Lcd>::value) {
+            return lcd.command(cmd, params, size) == ESP_OK ? RENDER_OK
+                : RENDER_FAIL;
+        } else {
+            if(lcd.send_command(cmd) != espidf::spi_result::success) {
+                return RENDER_FAIL;
+            }
+            if(size > 0 && lcd.send_data(params, size)
+                    != espidf::spi_result::success) {
+                return RENDER_FAIL;
+            }
+            return RENDER_OK;
+        }
+    }
+
+    /**
+     * @brief Sets the order in which pixel writes fill the panel memory
+     *
+     * @param rotation One of the rotations of the drivers. 0 is the panel's
+     *      native scan order.
+     */
+    static render_err_t scan_order(Lcd &lcd, uint8_t rotation) {
+        const uint8_t madctl = st7735_madctl(rotation);
+        return command(lcd, ST7735_MADCTL, &madctl, 1);
+    }
+
+    /**
+     * @brief Writes pixels to a window of panel memory
+     *
+     * Bypasses the driver's rotation and clipping, the window is in the
+     * order set with scan_order().
+     *
+     * @param r The window
+     * @param first First byte of the pixels, in framebuffer byte order
+     * @param stride Bytes from one row of the pixels to the next. Rows that
+     *      follow each other in memory are sent as one block.
+     */
+    static render_err_t write(Lcd &lcd, const gfx::rect16 &r,
+            const uint8_t *first, size_t stride) {
+        if constexpr(is_esp_lcd<Lcd>::value) {
+            return lcd.write_memory(r, first, stride)
+                == gfx::gfx_result::success ? RENDER_OK : RENDER_FAIL;
+        } else {
+            const uint8_t caset[4] = { (uint8_t)(r.x1 >> 8), (uint8_t)r.x1,
+                (uint8_t)(r.x2 >> 8), (uint8_t)r.x2 };
+            const uint8_t raset[4] = { (uint8_t)(r.y1 >> 8), (uint8_t)r.y1,
+                (uint8_t)(r.y2 >> 8), (uint8_t)r.y2 };
+            if(command(lcd, ST7735_CASET, caset, sizeof(caset)) != RENDER_OK
+                    || command(lcd, ST7735_RASET, raset, sizeof(raset))
+                        != RENDER_OK
+                    || command(lcd, ST7735_RAMWR) != RENDER_OK) {
+                return RENDER_FAIL;
+            }
+            const size_t row = r.width() * sizeof(uint16_t);
+            if(row == stride) {
+                // One block, in pieces the SPI bus takes at once
+                size_t left = row * r.height();
+                while(left > 0) {
+                    const size_t n = left < chunk ? left : chunk;
+                    if(lcd.send_data(first, n)
+                            != espidf::spi_result::success) {
+                        return RENDER_FAIL;
+                    }
+                    first += n;
+                    left -= n;
+                }
+                return RENDER_OK;
+            }
+            for(uint16_t y = r.y1; y <= r.y2; y++, first += stride) {
+                if(lcd.send_data(first, row) != espidf::spi_result::success) {
+                    return RENDER_FAIL;
+                }
+            }
+            return RENDER_OK;
+        }
+    }
+
+    /**
+     * @brief Sets the interface pixel format
+     *
+     * @param bits 12 for RGB444 (see write_rgb444()), 16 for RGB565
+     */
+    static render_err_t pixel_format(Lcd &lcd, uint8_t bits) {
+        const uint8_t colmod = bits == 12 ? ST7735_COLMOD_12BIT
+            : ST7735_COLMOD_16BIT;
+        return command(lcd, ST7735_COLMOD, &colmod, 1);
+    }
+
+    /**
+     * @brief Writes pixels to a window of panel memory packed as RGB444
+     *
+     * Like write(), for a panel switched to 12 bit with pixel_format(). The
+     * pixels are converted on the way, the source stays RGB565.
+     *
+     * @param scratch Receives the packed pixels before they are sent, chunk
+     *      bytes owned by the caller. Not used by esp_lcd drivers, which
+     *      pack into their own transfer buffers.
+     */
+    static render_err_t write_rgb444(Lcd &lcd, const gfx::rect16 &r,
+            const uint8_t *first, size_t stride, uint8_t *scratch) {
+        if constexpr(is_esp_lcd<Lcd>::value) {
+            return lcd.write_memory_rgb444(r, first, stride)
+                == gfx::gfx_result::success ? RENDER_OK : RENDER_FAIL;
+        } else {
+            const uint8_t caset[4] = { (uint8_t)(r.x1 >> 8), (uint8_t)r.x1,
+                (uint8_t)(r.x2 >> 8), (uint8_t)r.x2 };
+            const uint8_t raset[4] = { (uint8_t)(r.y1 >> 8), (uint8_t)r.y1,
+                (uint8_t)(r.y2 >> 8), (uint8_t)r.y2 };
+            if(command(lcd, ST7735_CASET, caset, sizeof(caset)) != RENDER_OK
+                    || command(lcd, ST7735_RASET, raset, sizeof(raset))
+                        != RENDER_OK
+                    || command(lcd, ST7735_RAMWR) != RENDER_OK) {
+                return RENDER_FAIL;
+            }
+            // The stream continues over the pieces, so every piece but the
+            // last holds an even number of pixels
+            const uint16_t w = r.width();
+            uint16_t rows = chunk * 2 / 3 / w;
+            if(w & 1) {
+                rows &= ~1;
+            }
+            for(uint16_t y = r.y1; y <= r.y2; y += rows) {
+                const uint16_t n = y + rows - 1 < r.y2 ? rows : r.y2 - y + 1;
+                const size_t size = rgb565::pack444(scratch, first, stride,
+                    w, n);
+                if(lcd.send_data(scratch, size)
+                        != espidf::spi_result::success) {
+                    return RENDER_FAIL;
+                }
+                first += stride * n;
+            }
+            return RENDER_OK;
+        }
+    }
+
+    /**
+     * @brief Defines the vertical scroll area in panel lines
+     *
+     * @param tfa Lines in the top fixed area
+     * @param vsa Lines in the scroll area
+     * @param bfa Lines in the bottom fixed area. tfa + vsa + bfa must equal
+     *      the number of panel lines.
+     */
+    static render_err_t scroll_area(Lcd &lcd, uint16_t tfa, uint16_t vsa,
+            uint16_t bfa) {
+        const uint8_t params[6] = {
+            (uint8_t)(tfa >> 8), (uint8_t)tfa,
+            (uint8_t)(vsa >> 8), (uint8_t)vsa,
+            (uint8_t)(bfa >> 8), (uint8_t)bfa
+        };
+        return command(lcd, ST7735_VSCRDEF, params, sizeof(params));
+    }
+
+    /**
+     * @brief Sets the memory line shown on the first line of the scroll area
+     */
+    static render_err_t scroll_start(Lcd &lcd, uint16_t line) {
+        const uint8_t params[2] = { (uint8_t)(line >> 8), (uint8_t)line };
+        return command(lcd, ST7735_VSCSAD, params, sizeof(params));
+    }
+
+    /**
+     * @brief Leaves scroll mode
+     */
+    static render_err_t normal_mode(Lcd &lcd) {
+        return command(lcd, ST7735_NORON);
+    }
+};
+
+} // namespace bcd_render
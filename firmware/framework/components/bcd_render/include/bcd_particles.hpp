@@ -0,0 +1,166 @@
+/**
+ * @file    bcd_particles.hpp
+ * @brief   Fixed size particle system for short effects
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Line clears and hard drops throw out a burst of single pixel particles.
+ * The particles live in a pool of fixed size that is part of the object, so
+ * effects never allocate, however long a session runs. The pool is laid out
+ * as one array per field, which keeps the update loop a run over a few
+ * contiguous arrays. Positions and velocities are fixed point with 8
+ * fractional bits and the simulation advances in fixed steps of one frame,
+ * at most maxSteps per update(). Together with the pool size this bounds the
+ * work of a frame.
+ *
+ * Particles are drawn as single pixels into the shadow framebuffer of a
+ * display list (see display_list::points()). draw() remembers the pixels it
+ * covered, erase() puts them back, so only the particle pixels are sent. A
+ * frame therefore erases the particles before anything else is drawn and
+ * draws them after everything else.
+ *
+ * Usage:
+ *      bcd_render::particle_system particles;
+ *      particles.emit(srect16(55, 50, 104, 54), 32, color<pixel_type>::white,
+ *          256, 384, 40);
+ *      while(true) {
+ *          int64_t now = frameClock.wait();
+ *          particles.erase(dl);
+ *          particles.update(now);
+ *          ... draw the frame ...
+ *          particles.draw(dl);
+ *          dl.flush();
+ *      }
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+class particle_system {
+    public:
+        using pixel_type = gfx::rgb_pixel<16>;
+
+        static constexpr size_t capacity = CONFIG_RENDER_PARTICLES;
+        /** Length of a simulation step in microseconds */
+        static constexpr uint32_t stepUs = 1000000 / CONFIG_RENDER_FRAME_RATE;
+        /** Steps simulated by one update(). Time beyond that is dropped. */
+        static constexpr uint32_t maxSteps = 4;
+
+        particle_system() = default;
+        particle_system(const particle_system &) = delete;
+        particle_system &operator=(const particle_system &) = delete;
+
+        /**
+         * @brief Particles leaving this area die. The whole screen by
+         *      default.
+         */
+        void clip(const gfx::srect16 &area) { bounds = area; }
+
+        /**
+         * @brief Downward acceleration in 1/256 pixel per step squared
+         */
+        void gravity(int16_t acceleration) { fall = acceleration; }
+
+        /**
+         * @brief Starts particles at random positions within an area
+         *
+         * If the pool is full, the remaining particles are not started.
+         *
+         * @param area Area the particles start in
+         * @param amount Number of particles
+         * @param tint Colour of the particles
+         * @param spread Largest speed in any direction, in 1/256 pixel per
+         *      step
+         * @param lift Upward speed added to every particle, in 1/256 pixel
+         *      per step
+         * @param lifetime Steps a particle lives. Every particle gets between
+         *      3/4 and all of it.
+         * @return Number of particles started
+         */
+        size_t emit(const gfx::srect16 &area, size_t amount, pixel_type tint,
+            int16_t spread, int16_t lift, uint16_t lifetime);
+
+        /**
+         * @brief Advances the particles to the given time
+         *
+         * @param now Time in microseconds, eg. from frame_clock::wait()
+         */
+        void update(int64_t now);
+
+        /**
+         * @brief Restores the pixels under the particles drawn last
+         */
+        template<typename List>
+        render_err_t erase(List &list) {
+            if(shownCount == 0) {
+                return RENDER_OK;
+            }
+            render_err_t err = list.points(shownX, shownY, under, shownCount);
+            shownCount = 0;
+            return err;
+        }
+
+        /**
+         * @brief Draws the particles, remembering the pixels under them
+         *
+         * @return RENDER_OK on success, RENDER_ERR_NOT_SUPPORTED if the list
+         *      has no shadow framebuffer to restore the pixels from
+         */
+        template<typename List>
+        render_err_t draw(List &list) {
+            if(count == 0) {
+                return RENDER_OK;
+            }
+            for(size_t i = 0; i < count; i++) {
+                shownX[i] = x[i] >> 8;
+                shownY[i] = y[i] >> 8;
+            }
+            render_err_t err = list.points(shownX, shownY, color, count,
+                under);
+            shownCount = err == RENDER_OK ? count : 0;
+            return err;
+        }
+
+        /**
+         * @brief Drops all particles without erasing them
+         *
+         * For when the screen is redrawn anyway.
+         */
+        void clear();
+
+        size_t active() const { return count; }
+
+    private:
+        // Live particles are kept packed at the start of the arrays
+        int32_t x[capacity];                                                    /**< 24.8 fixed point */
+        int32_t y[capacity];
+        int16_t vx[capacity];                                                   /**< 8.8 fixed point, per step */
+        int16_t vy[capacity];
+        uint16_t life[capacity];                                                /**< Steps left */
+        pixel_type color[capacity];
+        size_t count = 0;
+
+        // Pixels covered by the last draw()
+        int16_t shownX[capacity];
+        int16_t shownY[capacity];
+        pixel_type under[capacity];
+        size_t shownCount = 0;
+
+        gfx::srect16 bounds { 0, 0, INT16_MAX, INT16_MAX };
+        int16_t fall = 12;
+        int64_t last = 0;
+        uint32_t carry = 0;
+        uint32_t seed = 0x2545f491;
+
+        uint32_t random();
+        void remove(size_t i);
+};
+
+} // namespace bcd_render
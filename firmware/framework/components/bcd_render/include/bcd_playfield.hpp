@@ -0,0 +1,189 @@
+/**
+ * @file    bcd_playfield.hpp
+ * @brief   Board cells drawn as tiles of a fixed size
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * tile_grid places a board of Columns x Rows square cells of CellSize
+ * pixels on the screen. It turns cell positions into surface and screen
+ * rectangles, so a layout is described by its cell size and its origin
+ * instead of numbers spread through the drawing code.
+ *
+ * playfield_renderer keeps the cells in an indexed surface (see
+ * bcd_indexed_surface.hpp) together with their palette. The cell size is a
+ * template parameter, so every cell is drawn with the tile kernels of the
+ * surface, unrolled for exactly that size. Boards with other cell sizes or
+ * dimensions are another instance of the same template.
+ *
+ * Usage:
+ *      using field_type = bcd_render::playfield_renderer<pixel_type, 5, 10,
+ *          22>;
+ *      field_type field;
+ *      field.initialize(spoint16(55, 10));
+ *      field.color(1, color<pixel_type>::red);
+ *      field.set(3, 7, 1);
+ *      field.draw(dl, 3, 7);
+ *      dl.flush();
+ */
+#pragma once
+
+#include <stdint.h>
+#include "gfx_positioning.hpp"
+#include "bcd_render.hpp"
+#include "bcd_indexed_surface.hpp"
+
+namespace bcd_render {
+
+/**
+ * @brief Positions of the cells of a board
+ */
+template<uint16_t CellSize, uint16_t Columns, uint16_t Rows>
+class tile_grid {
+    public:
+        static constexpr uint16_t cell_size = CellSize;
+        static constexpr uint16_t columns = Columns;
+        static constexpr uint16_t rows = Rows;
+        static constexpr uint16_t width = Columns * CellSize;                   /**< Pixels */
+        static constexpr uint16_t height = Rows * CellSize;                     /**< Pixels */
+
+        static_assert(CellSize > 0 && Columns > 0 && Rows > 0,
+            "Grids have cells");
+
+        /**
+         * @brief Pixels covered by a number of cells
+         */
+        static constexpr int pixels(int cells) { return cells * CellSize; }
+
+        static gfx::size16 dimensions() { return gfx::size16(width, height); }
+
+        /**
+         * @brief Area of the cell (i, j) relative to the grid
+         */
+        static gfx::rect16 cell(int i, int j) {
+            return cells(i, j, 1, 1);
+        }
+
+        /**
+         * @brief Area of a block of cells relative to the grid
+         *
+         * @param i, j The top left cell
+         * @param w, h Size of the block in cells
+         */
+        static gfx::rect16 cells(int i, int j, int w, int h) {
+            return gfx::rect16(gfx::point16(pixels(i), pixels(j)),
+                gfx::size16(pixels(w), pixels(h)));
+        }
+
+        /**
+         * @brief Moves the grid to a screen position
+         */
+        void place(const gfx::spoint16 &origin) { this->origin = origin; }
+
+        const gfx::spoint16 &position() const { return origin; }
+
+        /**
+         * @brief Screen area of the whole grid
+         */
+        gfx::srect16 area() const {
+            return screen(gfx::rect16(gfx::point16(0, 0), dimensions()));
+        }
+
+        /**
+         * @brief Screen area of an area relative to the grid
+         */
+        gfx::srect16 screen(const gfx::rect16 &local) const {
+            return ((gfx::srect16)local).offset(origin.x, origin.y);
+        }
+
+        /**
+         * @brief Screen area of the cell (i, j)
+         */
+        gfx::srect16 screen(int i, int j) const {
+            return screen(cell(i, j));
+        }
+
+    private:
+        gfx::spoint16 origin { 0, 0 };
+};
+
+/**
+ * @brief Board cells in an indexed surface, drawn through a display list
+ *
+ * Cells hold palette indices 0 - 15, Pixel is the format of the palette
+ * colours and of the sprites drawn on top of the board.
+ */
+template<typename Pixel, uint16_t CellSize, uint16_t Columns, uint16_t Rows>
+class playfield_renderer : public tile_grid<CellSize, Columns, Rows> {
+    public:
+        using pixel_type = Pixel;
+        using grid = tile_grid<CellSize, Columns, Rows>;
+
+        static_assert(Pixel::bit_depth == 16, "Cells expand to RGB565");
+
+        /**
+         * @brief Allocates the surface with all cells at index 0
+         *
+         * @param origin Screen position of the top left cell
+         */
+        render_err_t initialize(const gfx::spoint16 &origin) {
+            grid::place(origin);
+            return surface.initialize(grid::dimensions());
+        }
+
+        bool initialized() const { return surface.initialized(); }
+
+        /**
+         * @brief Sets the colour of a palette index
+         */
+        void color(uint8_t index, Pixel color) { palette.set(index, color); }
+
+        /**
+         * @brief Fills the cell (i, j) with a palette index
+         */
+        void set(int i, int j, uint8_t index) {
+            surface.tile<CellSize>(grid::pixels(i), grid::pixels(j), index);
+        }
+
+        /**
+         * @brief Fills the cell (i, j) and gives it an outline of another
+         *      index
+         */
+        void outlined(int i, int j, uint8_t index, uint8_t outline) {
+            set(i, j, index);
+            surface.tile_outline<CellSize>(grid::pixels(i), grid::pixels(j),
+                outline);
+        }
+
+        /**
+         * @brief Records the cell (i, j) into a display list
+         *
+         * The surface is read at flush time.
+         */
+        template<typename List>
+        void draw(List &list, int i, int j) const {
+            list.indexed(grid::screen(i, j), surface, grid::cell(i, j),
+                palette);
+        }
+
+        /**
+         * @brief Records a solid cell on top of the board
+         *
+         * @param i Column of the cell
+         * @param y Top of the cell in pixels from the top of the grid, so
+         *      sprites can move between rows
+         */
+        template<typename List>
+        void sprite(List &list, int i, int y, Pixel color) const {
+            list.filled_rectangle(grid::screen(gfx::rect16(
+                gfx::point16(grid::pixels(i), y),
+                gfx::size16(CellSize, CellSize))), color);
+        }
+
+    private:
+        indexed_surface surface;
+        indexed_palette palette;
+};
+
+} // namespace bcd_render
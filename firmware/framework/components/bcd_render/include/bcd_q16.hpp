@@ -0,0 +1,71 @@
+/**
+ * @file    bcd_q16.hpp
+ * @brief   Lossless 16 bit image format
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * The screens in data/ are pixel art with large flat areas and hard edges.
+ * JPEG blurs the edges and spends most of the decode time in the IDCT. q16
+ * is a variant of QOI (https://qoiformat.org) that works on RGB565: it
+ * stores runs, references to recently seen pixels and small differences to
+ * the previous pixel. Decoding is a byte-wise loop without any arithmetic
+ * beyond adds and shifts.
+ *
+ * File layout:
+ *      "Q16I", u16 width, u16 height (little endian), then the ops:
+ *      00iiiiii                INDEX   pixel from the 64 entry table
+ *      01rrggbb                DIFF    r, g, b change by -2..1
+ *      10gggggg rrrrbbbb       LUMA    g changes by -32..31, r and b by
+ *                                      that plus -8..7
+ *      11nnnnnn                RUN     previous pixel 1..62 more times
+ *      11111110 hhhhhhhh llllllll  RGB pixel, high byte first
+ * The previous pixel starts as black, every pixel is stored in the table at
+ * (r * 3 + g * 5 + b * 7) % 64. tools/q16.py converts images.
+ *
+ * q16_image::load() has the same interface as gfx::jpeg_image::load(), but
+ * hands out full width strips instead of MCUs.
+ *
+ * Usage:
+ *      file_stream fs("/spiffs/start_screen.q16");
+ *      bcd_render::q16_image::load(&fs, callback, state);
+ */
+#pragma once
+
+#include <stdint.h>
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+class q16_image {
+    public:
+        using region_type = gfx::bitmap<gfx::rgb_pixel<16>>;
+        using callback_type = gfx::gfx_result (*)(gfx::size16 dimensions,
+            region_type &region, gfx::point16 location, void *state);
+
+        /** Rows handed out per callback */
+        static constexpr uint16_t stripHeight = 16;
+
+        /**
+         * @brief Decodes an image strip by strip
+         *
+         * @param in Stream positioned at the header
+         * @param callback Called for every strip, top to bottom. The strip
+         *      is only valid during the call.
+         * @param state Passed to the callback
+         * @return gfx_result::invalid_format if the stream is not a q16
+         *      image, gfx_result::out_of_memory if the strip buffer cannot
+         *      be allocated, otherwise the first error of the callback.
+         */
+        static gfx::gfx_result load(gfx::stream *in, callback_type callback,
+            void *state);
+
+        /**
+         * @brief Returns true if path has the .q16 extension
+         */
+        static bool matches(const char *path);
+};
+
+} // namespace bcd_render
@@ -0,0 +1,110 @@
+/**
+ * @file    bcd_quality.hpp
+ * @brief   Render quality that follows the measured frame load
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * A frame that does not fit its period is dropped by the frame clock, which
+ * shows as stutter. Under load, eg. a multi line clear while Wi-Fi is busy,
+ * it is better to draw a little less than to drop frames. The quality
+ * governor watches the frame clock and picks a quality level that screens
+ * draw with.
+ *
+ * The load is the work time of a frame (frame_clock::busy()) in percent of
+ * the period, averaged over the last few frames. Above
+ * CONFIG_RENDER_QUALITY_HIGH_LOAD, or when frames were dropped, quality goes
+ * down one level. After a step down the average gets a few frames to follow
+ * before the next one. Quality goes up one level once the load has stayed
+ * below CONFIG_RENDER_QUALITY_LOW_LOAD for CONFIG_RENDER_QUALITY_RECOVER
+ * frames in a row, so it does not flip back and forth at the limit.
+ *
+ * What a level leaves out is up to the screen. effects() scales the number
+ * of particles, outlines() tells whether decorations like the ghost outline
+ * are drawn.
+ *
+ * Usage:
+ *      quality.reset();
+ *      while(true) {
+ *          int64_t now = clock.wait();
+ *          quality.update(clock);
+ *          particles.emit(area, quality.effects(24), tint, 128, 256, 45);
+ *          ...
+ *      }
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bcd_render.hpp"
+#include "bcd_frame_clock.hpp"
+
+namespace bcd_render {
+
+enum class quality_e : uint8_t {
+    FULL,                                                                       /**< Everything */
+    REDUCED,                                                                    /**< Half the effects */
+    MINIMAL,                                                                    /**< A quarter of the effects, no outlines */
+};
+
+/**
+ * @brief Statistics of a quality governor
+ */
+struct quality_stats {
+    uint32_t frames = 0;                                                        /**< Frames since reset() */
+    quality_e level = quality_e::FULL;
+    uint16_t load = 0;                                                          /**< Average frame time in percent of the period */
+    uint16_t peak = 0;                                                          /**< Longest frame since reset() in percent */
+    uint32_t overruns = 0;                                                      /**< Frames longer than the period */
+    uint32_t downgrades = 0;
+    uint32_t upgrades = 0;
+    uint32_t reduced = 0;                                                       /**< Frames drawn below FULL */
+};
+
+class quality_governor {
+    public:
+        /**
+         * @brief Starts over at full quality
+         *
+         * Call when a screen loop starts. Its first frame includes setting
+         * up the screen and is not counted.
+         */
+        void reset();
+
+        /**
+         * @brief Takes the measurements of the last frame
+         *
+         * Call once per frame, right after frame_clock::wait().
+         */
+        void update(const frame_clock &clock);
+
+        quality_e level() const { return stats.level; }
+
+        /**
+         * @brief Number of particles to emit at the current level
+         *
+         * @param amount Number at full quality
+         */
+        size_t effects(size_t amount) const {
+            return amount >> (uint8_t)stats.level;
+        }
+
+        /**
+         * @brief Whether decorative outlines are drawn
+         */
+        bool outlines() const { return stats.level != quality_e::MINIMAL; }
+
+        const quality_stats &statistics() const { return stats; }
+
+    private:
+        quality_stats stats;
+        uint32_t average = 0;                                                   /**< Load in 1/16 percent */
+        uint32_t lastDropped = 0;
+        uint16_t settle = 0;                                                    /**< Frames until the next step down */
+        uint16_t calm = 0;                                                      /**< Frames below the low load */
+
+        void change(quality_e level);
+};
+
+} // namespace bcd_render
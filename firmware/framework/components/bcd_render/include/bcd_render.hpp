@@ -0,0 +1,37 @@
+/**
+ * @file    bcd_render.hpp
+ * @brief   Common definitions of the render component
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * The render component contains the building blocks that sit between the
+ * firmware and the display driver. Firmware records what it wants to draw and
+ * the render component decides how to get it to the panel with as few bus
+ * transactions as possible.
+ */
+#pragma once
+
+#include "sdkconfig.h"
+#include <freertos/FreeRTOS.h>
+#include "esp_log.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Menuconfig options
+////////////////////////////////////////////////////////////////////////////////
+#define TAG_RENDER CONFIG_TAG_RENDER
+
+////////////////////////////////////////////////////////////////////////////////
+// Error handling
+////////////////////////////////////////////////////////////////////////////////
+typedef BaseType_t render_err_t;
+
+#define RENDER_FAIL                 -1                                          /**< Generic failure */
+#define RENDER_OK                   0x000                                       /**< All good */
+#define RENDER_ERR_NO_MEM           0x101                                       /**< Could not allocate buffer */
+#define RENDER_ERR_NOT_INITIALIZED  0x102                                       /**< Object not initialised */
+#define RENDER_ERR_DRAW             0x103                                       /**< gfx returned an error */
+#define RENDER_ERR_NOT_SUPPORTED    0x104                                       /**< Not possible with this panel setup */
+#define RENDER_ERR_NOT_FOUND        0x105                                       /**< File does not exist */
+#define RENDER_ERR_TIMEOUT          0x106                                       /**< Gave up waiting */
@@ -0,0 +1,164 @@
+/**
+ * @file    bcd_rgb565.hpp
+ * @brief   Fill and copy kernels for RGB565 buffers
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * gfx fills and blits bitmaps pixel by pixel through its generic paths, which
+ * convert, clip and address every pixel on its own. For the common case of an
+ * RGB565 bitmap drawn into another one, or filled with one colour, the work
+ * is nothing more than storing the same word many times or copying rows.
+ * These kernels do exactly that: fills store two pixels per 32 bit word,
+ * four words per loop iteration, copies are one memcpy() per row.
+ *
+ * copy_strided() copies between buffers whose rows run in different
+ * directions, like a frame composed in the panel's native orientation and a
+ * bitmap in screen orientation.
+ *
+ * pack444() converts pixels for the 12 bit interface mode of the panel,
+ * which takes two pixels in three bytes.
+ *
+ * blend() lays a translucent colour over an area, for overlays and dimmed
+ * backgrounds. It spreads the green channel of a pixel into the upper half
+ * of a 32 bit word, so all three channels of a pixel are weighted with a
+ * single multiply, with 5 bits of alpha. blend_mask() does the same with an
+ * alpha value per pixel, for anti-aliased glyphs (see bcd_glyph_atlas.hpp).
+ * On the ESP32-S3 both blend 16 pixels at a time with the PIE vector
+ * instructions, wherever the pixels follow each other in memory, with the
+ * same results. Other targets and the columns of rotated views use the word
+ * wide code.
+ *
+ * The kernels work on plain buffers with the pixels in the byte order of gfx
+ * bitmaps (high byte first) and do not clip, so they build on the host as
+ * well (see tools/blit_bench.cpp). bcd_blit.hpp selects them for gfx bitmaps.
+ *
+ * Usage:
+ *      // Fill a 10x10 square at (5, 5) of a 128 pixel wide buffer with red
+ *      bcd_render::rgb565::fill(buffer, 128 * 2, 5, 5, 10, 10, 0xf800);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace bcd_render {
+namespace rgb565 {
+
+/**
+ * @brief Fills a rectangle with one colour
+ *
+ * @param base First byte of the buffer
+ * @param stride Bytes per row of the buffer
+ * @param x, y Top left corner of the rectangle
+ * @param width, height Size of the rectangle
+ * @param color The colour as native RGB565 value
+ */
+void fill(uint8_t *base, size_t stride, uint16_t x, uint16_t y,
+    uint16_t width, uint16_t height, uint16_t color);
+
+/**
+ * @brief Copies a rectangle of pixels between two buffers
+ *
+ * The areas must not overlap.
+ *
+ * @param destination First byte of the destination rectangle
+ * @param destinationStride Bytes per row of the destination buffer
+ * @param source First byte of the source rectangle
+ * @param sourceStride Bytes per row of the source buffer
+ * @param width, height Size of the rectangle
+ */
+void copy(uint8_t *destination, size_t destinationStride,
+    const uint8_t *source, size_t sourceStride, uint16_t width,
+    uint16_t height);
+
+/**
+ * @brief Copies a rectangle of pixels, stepping through both buffers in
+ *      any direction
+ *
+ * Steps are in bytes and may be negative, so a row of the source can be
+ * written as a column of the destination. The areas must not overlap.
+ *
+ * @param destination First byte of the first destination pixel
+ * @param destinationX, destinationY Step to the next pixel and the next row
+ *      in the destination
+ * @param source First byte of the first source pixel
+ * @param sourceX, sourceY Step to the next pixel and the next row in the
+ *      source
+ * @param width, height Size of the rectangle
+ */
+void copy_strided(uint8_t *destination, ptrdiff_t destinationX,
+    ptrdiff_t destinationY, const uint8_t *source, ptrdiff_t sourceX,
+    ptrdiff_t sourceY, uint16_t width, uint16_t height);
+
+/**
+ * @brief Packs a rectangle of pixels as RGB444, two pixels in three bytes
+ *
+ * The rows are packed as one stream, the way the panel reads a window in
+ * its 12 bit mode (COLMOD 0x03). Every channel keeps its upper four bits.
+ * An odd number of pixels ends with half a byte of padding.
+ *
+ * @param out Receives packed444Size(width * height) bytes
+ * @param source First byte of the source rectangle
+ * @param sourceStride Bytes per row of the source buffer
+ * @param width, height Size of the rectangle
+ * @return Number of bytes written
+ */
+size_t pack444(uint8_t *out, const uint8_t *source, size_t sourceStride,
+    uint16_t width, uint16_t height);
+
+/**
+ * @brief Bytes of a number of pixels packed by pack444()
+ */
+inline size_t packed444Size(size_t pixels) {
+    return (pixels * 3 + 1) / 2;
+}
+
+/**
+ * @brief Lays a translucent colour over a rectangle
+ *
+ * @param base First byte of the buffer
+ * @param stride Bytes per row of the buffer
+ * @param x, y Top left corner of the rectangle
+ * @param width, height Size of the rectangle
+ * @param color The colour as native RGB565 value
+ * @param alpha Opacity of the colour, 0 (invisible) to 255 (opaque)
+ */
+void blend(uint8_t *base, size_t stride, uint16_t x, uint16_t y,
+    uint16_t width, uint16_t height, uint16_t color, uint8_t alpha);
+
+/**
+ * @brief Lays a colour over a rectangle through an 8 bit alpha mask
+ *
+ * Steps are in bytes and may be negative, like for copy_strided(), so the
+ * mask can be laid over a rotated view. Pixels of alpha 0 are left alone.
+ *
+ * @param destination First byte of the first destination pixel
+ * @param destinationX, destinationY Step to the next pixel and the next row
+ *      in the destination
+ * @param mask Alpha of the first pixel, 0 (transparent) to 255 (opaque)
+ * @param maskStride Bytes per row of the mask
+ * @param width, height Size of the rectangle
+ * @param color The colour as native RGB565 value
+ */
+void blend_mask(uint8_t *destination, ptrdiff_t destinationX,
+    ptrdiff_t destinationY, const uint8_t *mask, size_t maskStride,
+    uint16_t width, uint16_t height, uint16_t color);
+
+/**
+ * @brief Mixes two native RGB565 values the way blend() does
+ */
+inline uint16_t mix(uint16_t foreground, uint16_t background,
+        uint8_t alpha) {
+    const uint32_t a = (alpha + 4) >> 3;
+    const uint32_t f = (foreground | ((uint32_t)foreground << 16))
+        & 0x07e0f81f;
+    const uint32_t b = (background | ((uint32_t)background << 16))
+        & 0x07e0f81f;
+    const uint32_t m = ((f * a + b * (32 - a)) >> 5) & 0x07e0f81f;
+    return (uint16_t)(m | (m >> 16));
+}
+
+} // namespace rgb565
+} // namespace bcd_render
@@ -0,0 +1,120 @@
+/**
+ * @file    bcd_row_diff.hpp
+ * @brief   Sends only the changed rows of an offscreen bitmap
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Code that renders a whole screen into a RAM bitmap, like the menus of
+ * ch405labs_gfx_menu, usually pushes the whole bitmap to the display after
+ * every change, although moving a cursor only changes a few rows. The row
+ * diff keeps a CRC of every row as last sent. send() compares the bitmap
+ * against them and sends each run of changed rows as one address window.
+ * Computing the CRCs of a 128x160 bitmap takes a fraction of the time it
+ * takes to send it.
+ *
+ * If something else drew on the display, invalidate() makes the next send()
+ * push the whole bitmap again.
+ *
+ * Usage:
+ *      bcd_render::row_diff rows;
+ *      rows.initialize(bmp.dimensions().height);
+ *      mc.cursor->drawMenu(bmp, ...);
+ *      rows.send(lcd, bmp);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_rom_crc.h"
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+class row_diff {
+    public:
+        row_diff() = default;
+        row_diff(const row_diff &) = delete;
+        row_diff &operator=(const row_diff &) = delete;
+        ~row_diff() { deinitialize(); }
+
+        /**
+         * @brief Allocates one checksum per row. The first send() sends all
+         *      rows.
+         *
+         * @return RENDER_OK on success, RENDER_ERR_NO_MEM if send() has to
+         *      send the whole bitmap every time
+         */
+        render_err_t initialize(uint16_t rows);
+        void deinitialize();
+
+        /**
+         * @brief Makes the next send() send every row
+         */
+        void invalidate() { valid = false; }
+
+        /**
+         * @brief Sends the rows of source that changed since the last call
+         *
+         * source is drawn at the top left corner of the destination and must
+         * have the row count given to initialize().
+         */
+        template<typename Destination, typename Bitmap>
+        gfx::gfx_result send(Destination &destination, const Bitmap &source) {
+            static_assert(Bitmap::pixel_type::bit_depth % 8 == 0,
+                "Rows are compared byte wise");
+            const gfx::size16 size = source.dimensions();
+            if(crcs == nullptr || size.height != rows) {
+                rowCount += size.height;
+                windowCount++;
+                return gfx::draw::bitmap(destination,
+                    (gfx::srect16)source.bounds(), source, source.bounds());
+            }
+
+            const size_t stride = Bitmap::sizeof_buffer(gfx::size16(
+                size.width, 1));
+            const uint8_t *row = source.begin();
+            int32_t first = -1;
+            for(uint16_t y = 0; y <= size.height; y++, row += stride) {
+                bool changed = false;
+                if(y < size.height) {
+                    uint32_t crc = esp_rom_crc32_le(0, row, stride);
+                    changed = !valid || crc != crcs[y];
+                    crcs[y] = crc;
+                }
+                if(changed && first < 0) {
+                    first = y;
+                } else if(!changed && first >= 0) {
+                    // End of a run of changed rows
+                    gfx::rect16 band(0, first, size.width - 1, y - 1);
+                    rowCount += y - first;
+                    windowCount++;
+                    first = -1;
+                    gfx::gfx_result res = gfx::draw::bitmap(destination,
+                        (gfx::srect16)band, source, band);
+                    if(res != gfx::gfx_result::success) {
+                        valid = false;
+                        return res;
+                    }
+                }
+            }
+            valid = true;
+            return gfx::gfx_result::success;
+        }
+
+        /** Rows sent by all send() calls */
+        uint32_t rowsSent() const { return rowCount; }
+        /** Address windows sent by all send() calls */
+        uint32_t windowsSent() const { return windowCount; }
+
+    private:
+        uint32_t *crcs = nullptr;
+        uint16_t rows = 0;
+        bool valid = false;
+        uint32_t rowCount = 0;
+        uint32_t windowCount = 0;
+};
+
+} // namespace bcd_render
@@ -0,0 +1,137 @@
+/**
+ * @file    bcd_screen_cache.hpp
+ * @brief   Cache of precomposed static screens
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Menus and dialogs like the start, pause and end screens look the same every
+ * time they are shown, yet drawing them means rasterising ellipses, measuring
+ * and expanding text and sending many small areas. The screen cache renders
+ * the static part of such a screen once into an RGB565 surface in PSRAM.
+ * Showing the screen again is a single bitmap blit, and only what changes,
+ * like a selection marker or a score, is drawn on top.
+ *
+ * A screen is identified by a small number chosen by the caller. The compose
+ * function passed to get() draws the screen into a bitmap of the requested
+ * size. It only runs on the first get() or after the screen was invalidated,
+ * eg. because the font or the layout changed.
+ *
+ * Usage:
+ *      bcd_render::screen_cache screens;
+ *      const bcd_render::screen_cache::bitmap_type *screen;
+ *      if(screens.get(0, lcd.dimensions(), [&](auto &b) {
+ *              return draw::filled_ellipse(b, b.bounds(),
+ *                  color<pixel_type>::red);
+ *          }, &screen) == RENDER_OK) {
+ *          displayList.bitmap(lcd.bounds(), *screen, screen->bounds());
+ *      }
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include "esp_heap_caps.h"
+#include "gfx.hpp"
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+class screen_cache {
+    public:
+        using bitmap_type = gfx::bitmap<gfx::rgb_pixel<16>>;
+
+        static constexpr size_t screenCount = CONFIG_RENDER_SCREEN_CACHE_ENTRIES;
+
+        screen_cache() = default;
+        screen_cache(const screen_cache &) = delete;
+        screen_cache &operator=(const screen_cache &) = delete;
+        ~screen_cache() { clear(); }
+
+        /**
+         * @brief Returns a screen, composing it on the first call
+         *
+         * The screen stays valid until it is invalidated or the cache is
+         * cleared.
+         *
+         * @param id Number of the screen, below screenCount
+         * @param dimensions Size of the surface. A screen cached at another
+         *      size is composed again.
+         * @param compose Callable taking a bitmap_type & and returning a
+         *      gfx_result. Draws the static part of the screen.
+         * @param screen Receives the composed screen
+         * @return RENDER_OK on success, RENDER_ERR_NOT_SUPPORTED if id is out
+         *      of range, RENDER_ERR_NO_MEM if the surface cannot be allocated
+         *      and RENDER_ERR_DRAW if compose failed. On errors the caller
+         *      draws the screen directly.
+         */
+        template<typename Compose>
+        render_err_t get(uint8_t id, gfx::size16 dimensions, Compose compose,
+                const bitmap_type **screen) {
+            if(id >= screenCount) {
+                return RENDER_ERR_NOT_SUPPORTED;
+            }
+            entry &e = entries[id];
+            if(e.composed && e.image->dimensions().width == dimensions.width
+                    && e.image->dimensions().height == dimensions.height) {
+                hitCount++;
+                *screen = e.image;
+                return RENDER_OK;
+            }
+
+            missCount++;
+            render_err_t err = reserve(e, dimensions);
+            if(err != RENDER_OK) {
+                return err;
+            }
+            if(compose(*e.image) != gfx::gfx_result::success) {
+                ESP_LOGE(TAG_RENDER, "Composing screen %u failed.", id);
+                drop(e);
+                return RENDER_ERR_DRAW;
+            }
+            e.composed = true;
+            *screen = e.image;
+            return RENDER_OK;
+        }
+
+        /**
+         * @brief Makes the next get() of a screen compose it again
+         */
+        void invalidate(uint8_t id) {
+            if(id < screenCount) {
+                entries[id].composed = false;
+            }
+        }
+
+        /**
+         * @brief Frees all surfaces
+         */
+        void clear();
+
+        size_t used() const { return bytes; }
+        uint32_t hits() const { return hitCount; }
+        uint32_t misses() const { return missCount; }
+
+    private:
+        struct entry {
+            uint8_t *pixels = nullptr;
+            size_t size = 0;
+            bool composed = false;
+            bitmap_type *image = nullptr;
+            alignas(bitmap_type) uint8_t imageStorage[sizeof(bitmap_type)];
+        };
+
+        entry entries[screenCount];
+        size_t bytes = 0;
+        uint32_t hitCount = 0;
+        uint32_t missCount = 0;
+
+        // Keeps the surface of an entry if it has the right size, allocates
+        // a new one otherwise
+        render_err_t reserve(entry &e, gfx::size16 dimensions);
+        void drop(entry &e);
+};
+
+} // namespace bcd_render
@@ -0,0 +1,124 @@
+/**
+ * @file    bcd_timeline.hpp
+ * @brief   Non blocking tweens
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * A timeline animates integer values over time. Screens start tweens when
+ * something happens and keep running their loop: once per frame, update()
+ * writes the current value of every active tween and the screen draws with
+ * it. Input and game logic keep being processed while animations run.
+ *
+ * Tweens live in a fixed pool (CONFIG_RENDER_TWEENS), so starting one never
+ * allocates. Easing is done in 16.16 fixed point.
+ *
+ * Usage:
+ *      int32_t height = 0;
+ *      tween_handle h = tl.start(&height, 0, 34, 150000, ease::OUT);
+ *      while(true) {
+ *          tl.update(clock.wait());
+ *          ... draw with height ...
+ *          if(!tl.active(h)) break;
+ *      }
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bcd_render.hpp"
+
+namespace bcd_render {
+
+enum class ease : uint8_t {
+    LINEAR,
+    IN,                                                                         /**< Starts slow */
+    OUT,                                                                        /**< Ends slow */
+    IN_OUT,                                                                     /**< Starts and ends slow */
+    PULSE,                                                                      /**< Goes to the end value and back */
+};
+
+typedef int32_t tween_handle;
+#define RENDER_NO_TWEEN             -1                                          /**< Invalid tween handle */
+
+class timeline {
+    public:
+        static constexpr size_t capacity = CONFIG_RENDER_TWEENS;
+
+        /**
+         * @brief Starts a tween
+         *
+         * The value is set to from by the first update() after the delay and
+         * to to (from for PULSE) when the tween ends. It must stay valid until then, or the
+         * tween must be cancelled.
+         *
+         * @param value The value to animate
+         * @param from Start value
+         * @param to End value
+         * @param durationUs Duration in microseconds
+         * @param curve The easing curve
+         * @param delayUs Time to wait before the tween starts
+         * @return Handle of the tween, RENDER_NO_TWEEN if the pool is full
+         */
+        tween_handle start(int32_t *value, int32_t from, int32_t to,
+            uint32_t durationUs, ease curve = ease::LINEAR,
+            uint32_t delayUs = 0);
+
+        /**
+         * @brief Advances all tweens to the given time
+         *
+         * @param nowUs Current time in microseconds, eg. from
+         *      frame_clock::wait()
+         */
+        void update(int64_t nowUs);
+
+        /**
+         * @brief Whether the tween has not ended yet
+         */
+        bool active(tween_handle h) const;
+
+        /**
+         * @brief Stops a tween
+         *
+         * @param h The tween
+         * @param finish Set the value to the end value
+         */
+        void cancel(tween_handle h, bool finish = false);
+
+        /**
+         * @brief Stops all tweens without touching their values
+         */
+        void clear();
+
+        /**
+         * @brief Number of active tweens
+         */
+        size_t size() const;
+
+        /**
+         * @brief Eases progress t (0 - 65536) along a curve
+         */
+        static int32_t apply(ease curve, int32_t t);
+
+    private:
+        struct tween {
+            int32_t *value;
+            int32_t from;
+            int32_t to;
+            int64_t start;
+            uint32_t duration;
+            ease curve;
+            uint8_t generation;
+            bool used;
+        };
+
+        tween tweens[capacity] = {};
+        int64_t now = 0;
+
+        tween *find(tween_handle h);
+        const tween *find(tween_handle h) const;
+        static int32_t endValue(const tween &t);
+};
+
+} // namespace bcd_render
@@ -0,0 +1,84 @@
+#include "../include/bcd_dirty_rects.hpp"
+
+namespace bcd_render {
+
+uint32_t dirty_rects::area(const gfx::rect16 &r) {
+    return (uint32_t)r.width() * r.height();
+}
+
+gfx::rect16 dirty_rects::unite(const gfx::rect16 &a, const gfx::rect16 &b) {
+    return gfx::rect16(a.left() < b.left() ? a.left() : b.left(),
+        a.top() < b.top() ? a.top() : b.top(),
+        a.right() > b.right() ? a.right() : b.right(),
+        a.bottom() > b.bottom() ? a.bottom() : b.bottom());
+}
+
+// Sending two areas separately costs A + B pixels plus two windows, sending
+// their bounding box costs U pixels plus one window. A value <= 0 means that
+// merging does not cost more bus time than keeping them apart. Overlapping
+// areas are not always merged: their intersection counts twice in A + B,
+// since it is sent twice if they stay apart, but two thin areas that cross
+// can still have a bounding box much larger than both together.
+int32_t dirty_rects::mergeCost(const gfx::rect16 &a, const gfx::rect16 &b) {
+    return (int32_t)area(unite(a, b)) - (int32_t)area(a) - (int32_t)area(b)
+        - CONFIG_RENDER_WINDOW_COST_PX;
+}
+
+void dirty_rects::add(const gfx::rect16 &r) {
+    // Already covered areas are the most common case (eg. the same cell
+    // redrawn twice in a frame), so check them first.
+    for(size_t i = 0; i < count; i++) {
+        if(rects[i].contains(r)) {
+            return;
+        }
+    }
+
+    if(count == capacity) {
+        coalesce();
+    }
+    if(count < capacity) {
+        rects[count++] = r;
+        return;
+    }
+
+    // Still full. Merge into the rectangle where it hurts least.
+    size_t best = 0;
+    int32_t bestCost = INT32_MAX;
+    for(size_t i = 0; i < count; i++) {
+        int32_t cost = mergeCost(rects[i], r);
+        if(cost < bestCost) {
+            bestCost = cost;
+            best = i;
+        }
+    }
+    rects[best] = unite(rects[best], r);
+}
+
+void dirty_rects::coalesce() {
+    bool merged = true;
+    while(merged) {
+        merged = false;
+        for(size_t i = 0; i < count; i++) {
+            for(size_t j = i + 1; j < count; j++) {
+                if(mergeCost(rects[i], rects[j]) <= 0) {
+                    rects[i] = unite(rects[i], rects[j]);
+                    rects[j] = rects[--count];
+                    merged = true;
+                    // The grown rectangle may now be worth merging with
+                    // rectangles we already checked.
+                    j = i;
+                }
+            }
+        }
+    }
+}
+
+uint32_t dirty_rects::pixels() const {
+    uint32_t total = 0;
+    for(size_t i = 0; i < count; i++) {
+        total += area(rects[i]);
+    }
+    return total;
+}
+
+} // namespace bcd_render
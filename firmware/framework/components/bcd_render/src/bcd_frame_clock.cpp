@@ -0,0 +1,63 @@
+#include "../include/bcd_frame_clock.hpp"
+
+namespace bcd_render {
+
+render_err_t frame_clock::start(uint32_t fps) {
+    stop();
+    if(fps == 0) {
+        return RENDER_FAIL;
+    }
+    task = xTaskGetCurrentTaskHandle();
+    periodUs = 1000000 / fps;
+    frameStart = 0;
+    busyUs = 0;
+
+    const esp_timer_create_args_t args = {
+        .callback = &frame_clock::tick,
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "frame_clock",
+        .skip_unhandled_events = true,
+    };
+    if(esp_timer_create(&args, &timer) != ESP_OK) {
+        ESP_LOGE(TAG_RENDER, "Could not create frame timer.");
+        timer = nullptr;
+        return RENDER_FAIL;
+    }
+    if(esp_timer_start_periodic(timer, periodUs) != ESP_OK) {
+        ESP_LOGE(TAG_RENDER, "Could not start frame timer.");
+        esp_timer_delete(timer);
+        timer = nullptr;
+        return RENDER_FAIL;
+    }
+    return RENDER_OK;
+}
+
+void frame_clock::stop() {
+    if(timer != nullptr) {
+        esp_timer_stop(timer);
+        esp_timer_delete(timer);
+        timer = nullptr;
+    }
+}
+
+int64_t frame_clock::wait() {
+    if(frameStart != 0) {
+        busyUs = esp_timer_get_time() - frameStart;
+    }
+    if(timer != nullptr) {
+        // Clearing the count drops frames we were too slow for
+        uint32_t due = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if(due > 1) {
+            droppedCount += due - 1;
+        }
+    }
+    frameStart = esp_timer_get_time();
+    return frameStart;
+}
+
+void frame_clock::tick(void *arg) {
+    xTaskNotifyGive(((frame_clock *)arg)->task);
+}
+
+} // namespace bcd_render
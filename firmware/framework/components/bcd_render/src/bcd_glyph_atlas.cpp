@@ -0,0 +1,135 @@
+#include "../include/bcd_glyph_atlas.hpp"
+#include <string.h>
+#include "esp_heap_caps.h"
+
+namespace bcd_render {
+
+using coverage_type = gfx::bitmap<gfx::gsc_pixel<8>>;
+
+render_err_t glyph_atlas::initialize(const gfx::open_font &font,
+        float pixelHeight) {
+    deinitialize();
+    scale = font.scale(pixelHeight);
+
+    // Every glyph is as wide as its advance, the line is as high as the
+    // highest glyph
+    const gfx::ssize16 area(INT16_MAX, INT16_MAX);
+    char str[2] = { 0, 0 };
+    size_t pixels = 0;
+    uint16_t h = 0;
+    for(size_t i = 0; i < glyphCount; i++) {
+        str[0] = (char)(firstChar + i);
+        const gfx::ssize16 size = font.measure_text(area, gfx::spoint16(0, 0),
+            str, scale);
+        glyphs[i].offset = pixels;
+        glyphs[i].width = size.width > 0 ? size.width : 0;
+        pixels += glyphs[i].width;
+        if(size.height > h) {
+            h = size.height;
+        }
+    }
+    if(h == 0) {
+        return RENDER_ERR_DRAW;
+    }
+    for(glyph &g : glyphs) {
+        g.offset *= h;
+    }
+
+    // Masks are only read while drawing text, PSRAM is good enough
+    const size_t maskSize = pixels * h;
+    const size_t size = maskSize + glyphCount * glyphCount;
+    uint8_t *block = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if(block == nullptr) {
+        block = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    if(block == nullptr) {
+        ESP_LOGW(TAG_RENDER, "No memory for glyph atlas (%u bytes).",
+            (unsigned)size);
+        return RENDER_ERR_NO_MEM;
+    }
+    memset(block, 0, maskSize);
+    memset(block + maskSize, (uint8_t)unknown, glyphCount * glyphCount);
+
+    // White on black gives the coverage of every pixel
+    for(size_t i = 0; i < glyphCount; i++) {
+        const glyph &g = glyphs[i];
+        if(g.width == 0) {
+            continue;
+        }
+        str[0] = (char)(firstChar + i);
+        coverage_type mask(gfx::size16(g.width, h), block + g.offset);
+        if(gfx::draw::text(mask, (gfx::srect16)mask.bounds(),
+                gfx::spoint16(0, 0), str, font, scale,
+                gfx::color<gfx::gsc_pixel<8>>::white,
+                gfx::color<gfx::gsc_pixel<8>>::black, false)
+                != gfx::gfx_result::success) {
+            heap_caps_free(block);
+            return RENDER_ERR_DRAW;
+        }
+    }
+
+    this->font = &font;
+    lineHeight = h;
+    masks = block;
+    kerns = (int8_t *)(block + maskSize);
+    hitCount = 0;
+    missCount = 0;
+    ESP_LOGI(TAG_RENDER, "Glyph atlas: %u glyphs, %u px high, %u bytes.",
+        (unsigned)glyphCount, (unsigned)h, (unsigned)size);
+    return RENDER_OK;
+}
+
+void glyph_atlas::deinitialize() {
+    if(masks != nullptr) {
+        heap_caps_free(masks);
+        masks = nullptr;
+    }
+    kerns = nullptr;
+    font = nullptr;
+    lineHeight = 0;
+}
+
+int16_t glyph_atlas::kerning(char left, char right) {
+    if(kerns == nullptr) {
+        return 0;
+    }
+    const size_t l = index(left);
+    const size_t r = index(right);
+    int8_t &k = kerns[l * glyphCount + r];
+    if(k != unknown) {
+        hitCount++;
+        return k;
+    }
+
+    // The pair as the font lays it out, less the two advances
+    missCount++;
+    const char str[3] = { (char)(firstChar + l), (char)(firstChar + r), 0 };
+    const gfx::ssize16 size = font->measure_text(
+        gfx::ssize16(INT16_MAX, INT16_MAX), gfx::spoint16(0, 0), str, scale);
+    int16_t d = size.width - glyphs[l].width - glyphs[r].width;
+    if(d <= unknown) {
+        d = unknown + 1;
+    } else if(d > INT8_MAX) {
+        d = INT8_MAX;
+    }
+    k = (int8_t)d;
+    return k;
+}
+
+gfx::ssize16 glyph_atlas::measure_text(gfx::ssize16 area, const char *str) {
+    if(masks == nullptr) {
+        return gfx::ssize16(0, 0);
+    }
+    const gfx::srect16 bounds(gfx::spoint16(0, 0), area);
+    int16_t right = -1;
+    int16_t bottom = -1;
+    layout(bounds, bounds, str, [&](const gfx::srect16 &dst,
+            const uint8_t *, uint16_t) {
+        right = dst.right() > right ? dst.right() : right;
+        bottom = dst.bottom() > bottom ? dst.bottom() : bottom;
+        return gfx::gfx_result::success;
+    });
+    return gfx::ssize16(right + 1, bottom + 1);
+}
+
+} // namespace bcd_render
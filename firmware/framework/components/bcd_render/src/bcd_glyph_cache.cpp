@@ -0,0 +1,154 @@
+#include "../include/bcd_glyph_cache.hpp"
+#include <string.h>
+#include "esp_heap_caps.h"
+
+namespace bcd_render {
+
+render_err_t glyph_cache::initialize() {
+    if(pool != nullptr) {
+        return RENDER_OK;
+    }
+    // Tiles are copied on every text draw, internal RAM is the faster source
+    size_t size = slotSize * CONFIG_RENDER_GLYPH_CACHE_ENTRIES;
+    pool = (uint8_t *)heap_caps_malloc(size,
+        MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(pool == nullptr) {
+        pool = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    if(pool == nullptr) {
+        ESP_LOGW(TAG_RENDER, "No memory for glyph cache (%u bytes).",
+            (unsigned)size);
+        return RENDER_ERR_NO_MEM;
+    }
+    clear();
+    return RENDER_OK;
+}
+
+void glyph_cache::deinitialize() {
+    if(pool != nullptr) {
+        heap_caps_free(pool);
+        pool = nullptr;
+    }
+    clear();
+}
+
+void glyph_cache::clear() {
+    for(entry &e : entries) {
+        e.font = nullptr;
+    }
+    for(int16_t &b : buckets) {
+        b = none;
+    }
+}
+
+const uint8_t *glyph_cache::get(const gfx::font &font, char ch,
+        pixel_type foreground, pixel_type background, uint16_t *width) {
+    if(pool == nullptr) {
+        return nullptr;
+    }
+    uint8_t c = (uint8_t)ch;
+    if(c < (uint8_t)font.first_char() || c > (uint8_t)font.last_char()) {
+        c = (uint8_t)font.default_char();
+    }
+    const uint16_t fg = foreground.native_value;
+    const uint16_t bg = background.native_value;
+    const size_t b = bucket(&font, c, fg, bg);
+    for(int16_t i = buckets[b]; i != none; i = entries[i].next) {
+        entry &e = entries[i];
+        if(e.font == &font && e.ch == c && e.foreground == fg
+                && e.background == bg) {
+            e.lastUse = ++clock;
+            hitCount++;
+            *width = e.width;
+            return pool + i * slotSize;
+        }
+    }
+
+    missCount++;
+    const uint16_t w = font[c].width();
+    if(w == 0 || w > maxGlyphWidth || font.height() > maxGlyphHeight) {
+        return nullptr;
+    }
+    int16_t i = evict();
+    entry &e = entries[i];
+    e.font = &font;
+    e.ch = c;
+    e.width = w;
+    e.foreground = fg;
+    e.background = bg;
+    e.lastUse = ++clock;
+    e.next = buckets[b];
+    buckets[b] = i;
+    uint8_t *tile = pool + i * slotSize;
+    expand(font, c, fg, bg, tile, w);
+    *width = w;
+    return tile;
+}
+
+gfx::gfx_result glyph_cache::draw(uint8_t *buffer, gfx::size16 dimensions,
+        const gfx::srect16 &bounds, const char *str, const gfx::font &font,
+        pixel_type foreground, pixel_type background) {
+    gfx::srect16 screen(gfx::spoint16(0, 0), (gfx::ssize16)dimensions);
+    if(!screen.intersects(bounds)) {
+        return gfx::gfx_result::success;
+    }
+    const size_t stride = dimensions.width * sizeof(uint16_t);
+    return layout(bounds, bounds.crop(screen), str, font, foreground,
+        background, [&](const gfx::srect16 &dst, const uint8_t *tile,
+            uint16_t width, const gfx::rect16 &src) {
+            const size_t tileStride = width * sizeof(uint16_t);
+            const size_t len = (src.right() - src.left() + 1)
+                * sizeof(uint16_t);
+            const uint8_t *from = tile + src.top() * tileStride
+                + src.left() * sizeof(uint16_t);
+            uint8_t *to = buffer + dst.top() * stride
+                + dst.left() * sizeof(uint16_t);
+            for(int16_t y = dst.top(); y <= dst.bottom(); y++) {
+                memcpy(to, from, len);
+                from += tileStride;
+                to += stride;
+            }
+            return gfx::gfx_result::success;
+        });
+}
+
+// Returns a free slot, or unlinks the least recently used entry
+int16_t glyph_cache::evict() {
+    int16_t oldest = 0;
+    for(int16_t i = 0; i < CONFIG_RENDER_GLYPH_CACHE_ENTRIES; i++) {
+        if(entries[i].font == nullptr) {
+            return i;
+        }
+        if(entries[i].lastUse < entries[oldest].lastUse) {
+            oldest = i;
+        }
+    }
+    entry &e = entries[oldest];
+    int16_t *link = &buckets[bucket(e.font, e.ch, e.foreground,
+        e.background)];
+    while(*link != oldest) {
+        link = &entries[*link].next;
+    }
+    *link = e.next;
+    e.font = nullptr;
+    return oldest;
+}
+
+void glyph_cache::expand(const gfx::font &font, uint8_t ch,
+        uint16_t foreground, uint16_t background, uint8_t *tile,
+        uint16_t width) {
+    // Framebuffer byte order is big endian
+    const uint16_t on = (foreground >> 8) | (foreground << 8);
+    const uint16_t off = (background >> 8) | (background << 8);
+    const uint8_t *bits = font[ch].data();
+    const size_t rowBytes = (width + 7) / 8;
+    uint16_t *out = (uint16_t *)tile;
+    for(uint16_t y = 0; y < font.height(); y++) {
+        for(uint16_t x = 0; x < width; x++) {
+            *out++ = bits[x >> 3] & (0x80 >> (x & 7)) ? on : off;
+        }
+        bits += rowBytes;
+    }
+}
+
+} // namespace bcd_render
@@ -0,0 +1,161 @@
+#include "../include/bcd_image_cache.hpp"
+#include "../include/bcd_q16.hpp"
+#include <string.h>
+#include <sys/stat.h>
+
+namespace bcd_render {
+
+render_err_t image_cache::get(const char *path, const bitmap_type **image) {
+    if(strlen(path) >= pathLength) {
+        ESP_LOGW(TAG_RENDER, "Not caching %s: path too long.", path);
+        return RENDER_ERR_NOT_SUPPORTED;
+    }
+    struct stat st;
+    if(stat(path, &st) != 0) {
+        ESP_LOGE(TAG_RENDER, "Cannot open %s.", path);
+        return RENDER_ERR_NOT_FOUND;
+    }
+
+    entry *e = find(path);
+    if(e != nullptr && e->mtime == st.st_mtime) {
+        e->lastUse = ++clock;
+        hitCount++;
+        *image = e->image;
+        return RENDER_OK;
+    }
+    if(e != nullptr) {
+        // The file changed since it was decoded
+        drop(*e);
+    }
+
+    missCount++;
+    entry *slot = nullptr;
+    render_err_t err = decode(path, slot);
+    if(err != RENDER_OK) {
+        return err;
+    }
+    strcpy(slot->path, path);
+    slot->mtime = st.st_mtime;
+    slot->lastUse = ++clock;
+    *image = slot->image;
+    return RENDER_OK;
+}
+
+void image_cache::evict(const char *path) {
+    entry *e = find(path);
+    if(e != nullptr) {
+        drop(*e);
+    }
+}
+
+void image_cache::clear() {
+    for(entry &e : entries) {
+        drop(e);
+    }
+}
+
+image_cache::entry *image_cache::find(const char *path) {
+    for(entry &e : entries) {
+        if(e.pixels != nullptr && strcmp(e.path, path) == 0) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+void image_cache::drop(entry &e) {
+    if(e.pixels == nullptr) {
+        return;
+    }
+    e.image->~bitmap_type();
+    heap_caps_free(e.pixels);
+    e.pixels = nullptr;
+    e.path[0] = '\0';
+    bytes -= e.size;
+}
+
+image_cache::entry *image_cache::reserve(size_t size) {
+    while(true) {
+        entry *free = nullptr;
+        entry *oldest = nullptr;
+        for(entry &e : entries) {
+            if(e.pixels == nullptr) {
+                free = &e;
+            } else if(oldest == nullptr || e.lastUse < oldest->lastUse) {
+                oldest = &e;
+            }
+        }
+        if(free != nullptr && bytes + size <= capacity) {
+            return free;
+        }
+        if(oldest == nullptr) {
+            return nullptr;
+        }
+        drop(*oldest);
+    }
+}
+
+render_err_t image_cache::decode(const char *path, entry *&slot) {
+    gfx::file_stream fs(path);
+    if(!fs.caps().read) {
+        ESP_LOGE(TAG_RENDER, "Cannot open %s.", path);
+        return RENDER_ERR_NOT_FOUND;
+    }
+
+    struct state_t {
+        image_cache *cache;
+        entry *slot;
+        render_err_t err;
+    } state = { this, nullptr, RENDER_OK };
+
+    // The full size of the image is only known once the first region is
+    // decoded, so the buffer is allocated there.
+    auto store = [](
+            gfx::size16 dimensions, gfx::jpeg_image::region_type &region,
+            gfx::point16 location, void *arg) {
+        state_t *s = (state_t *)arg;
+        if(s->slot == nullptr) {
+            size_t size = bitmap_type::sizeof_buffer(dimensions);
+            entry *e = size <= s->cache->capacity
+                ? s->cache->reserve(size) : nullptr;
+            uint8_t *pixels = e != nullptr
+                ? (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM)
+                : nullptr;
+            if(pixels == nullptr) {
+                s->err = RENDER_ERR_NO_MEM;
+                return gfx::gfx_result::out_of_memory;
+            }
+            e->pixels = pixels;
+            e->size = size;
+            e->path[0] = '\0';
+            e->lastUse = s->cache->clock;
+            e->image = new (&e->imageStorage) bitmap_type(dimensions, pixels);
+            s->cache->bytes += size;
+            s->slot = e;
+        }
+        return gfx::draw::bitmap(*s->slot->image,
+            gfx::srect16((gfx::spoint16)location,
+                (gfx::ssize16)region.dimensions()),
+            region, region.bounds());
+    };
+    gfx::gfx_result res = q16_image::matches(path)
+        ? q16_image::load(&fs, store, &state)
+        : gfx::jpeg_image::load(&fs, store, &state);
+    fs.close();
+
+    if(res != gfx::gfx_result::success) {
+        if(state.slot != nullptr) {
+            drop(*state.slot);
+        }
+        if(state.err == RENDER_ERR_NO_MEM) {
+            ESP_LOGW(TAG_RENDER, "Not caching %s: does not fit.", path);
+            return RENDER_ERR_NO_MEM;
+        }
+        ESP_LOGE(TAG_RENDER, "Cannot decode %s.", path);
+        return RENDER_ERR_DRAW;
+    }
+    slot = state.slot;
+    return slot != nullptr ? RENDER_OK : RENDER_ERR_DRAW;
+}
+
+} // namespace bcd_render
@@ -0,0 +1,185 @@
+#include "../include/bcd_image_prefetcher.hpp"
+#include "../include/bcd_q16.hpp"
+#include <string.h>
+#include "esp_heap_caps.h"
+
+namespace bcd_render {
+
+render_err_t image_prefetcher::initialize() {
+    if(task != nullptr) {
+        return RENDER_OK;
+    }
+    request = xSemaphoreCreateBinary();
+    done = xSemaphoreCreateBinary();
+    if(request == nullptr || done == nullptr) {
+        deinitialize();
+        return RENDER_ERR_NO_MEM;
+    }
+    stop = false;
+#ifdef CONFIG_FREERTOS_UNICORE
+    BaseType_t core = tskNO_AFFINITY;
+#else
+    BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+#endif // CONFIG_FREERTOS_UNICORE
+    if(xTaskCreatePinnedToCore(&image_prefetcher::run, "prefetch",
+            CONFIG_RENDER_PREFETCH_STACK, this, tskIDLE_PRIORITY + 1, &task,
+            core) != pdPASS) {
+        ESP_LOGE(TAG_RENDER, "Could not create prefetch task.");
+        task = nullptr;
+        deinitialize();
+        return RENDER_ERR_NO_MEM;
+    }
+    return RENDER_OK;
+}
+
+void image_prefetcher::deinitialize() {
+    if(task != nullptr) {
+        if(pending) {
+            xSemaphoreTake(done, portMAX_DELAY);
+            pending = false;
+        }
+        // The task gives done once more on its way out
+        stop = true;
+        xSemaphoreGive(request);
+        xSemaphoreTake(done, portMAX_DELAY);
+        task = nullptr;
+    }
+    if(request != nullptr) {
+        vSemaphoreDelete(request);
+        request = nullptr;
+    }
+    if(done != nullptr) {
+        vSemaphoreDelete(done);
+        done = nullptr;
+    }
+    release(buffers[0]);
+    release(buffers[1]);
+}
+
+render_err_t image_prefetcher::prefetch(const char *path) {
+    if(task == nullptr) {
+        return RENDER_ERR_NOT_INITIALIZED;
+    }
+    if(strlen(path) >= pathLength) {
+        ESP_LOGW(TAG_RENDER, "Not prefetching %s: path too long.", path);
+        return RENDER_ERR_NOT_SUPPORTED;
+    }
+    if(pending) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    strcpy(this->path, path);
+    pending = true;
+    busy = true;
+    xSemaphoreGive(request);
+    return RENDER_OK;
+}
+
+render_err_t image_prefetcher::take(const bitmap_type **image,
+        TickType_t timeout) {
+    if(!pending) {
+        return RENDER_FAIL;
+    }
+    if(xSemaphoreTake(done, timeout) != pdTRUE) {
+        return RENDER_ERR_TIMEOUT;
+    }
+    pending = false;
+    if(result != RENDER_OK) {
+        return result;
+    }
+    buffer *b = front;
+    front = back;
+    back = b;
+    *image = front->image;
+    return RENDER_OK;
+}
+
+void image_prefetcher::run(void *arg) {
+    image_prefetcher *p = (image_prefetcher *)arg;
+    while(true) {
+        xSemaphoreTake(p->request, portMAX_DELAY);
+        if(p->stop) {
+            break;
+        }
+        p->result = p->decode();
+        p->busy = false;
+        xSemaphoreGive(p->done);
+    }
+    xSemaphoreGive(p->done);
+    vTaskDelete(nullptr);
+}
+
+render_err_t image_prefetcher::decode() {
+    gfx::file_stream fs(path);
+    if(!fs.caps().read) {
+        ESP_LOGE(TAG_RENDER, "Cannot open %s.", path);
+        return RENDER_ERR_NOT_FOUND;
+    }
+
+    struct state_t {
+        buffer *target;
+        bool allocated;
+    } state = { back, false };
+
+    // The size of the image is only known once the first region is
+    // decoded, so the buffer is (re)allocated there
+    auto store = [](
+            gfx::size16 dimensions, gfx::jpeg_image::region_type &region,
+            gfx::point16 location, void *arg) {
+        state_t *s = (state_t *)arg;
+        buffer &b = *s->target;
+        if(!s->allocated) {
+            size_t size = bitmap_type::sizeof_buffer(dimensions);
+            if(size > b.size) {
+                if(b.image != nullptr) {
+                    b.image->~bitmap_type();
+                    b.image = nullptr;
+                }
+                heap_caps_free(b.pixels);
+                b.size = 0;
+                b.pixels = (uint8_t *)heap_caps_malloc(size,
+                    MALLOC_CAP_SPIRAM);
+                if(b.pixels == nullptr) {
+                    return gfx::gfx_result::out_of_memory;
+                }
+                b.size = size;
+            }
+            if(b.image != nullptr) {
+                b.image->~bitmap_type();
+            }
+            b.image = new (&b.imageStorage) bitmap_type(dimensions, b.pixels);
+            s->allocated = true;
+        }
+        return gfx::draw::bitmap(*b.image,
+            gfx::srect16((gfx::spoint16)location,
+                (gfx::ssize16)region.dimensions()),
+            region, region.bounds());
+    };
+    gfx::gfx_result res = q16_image::matches(path)
+        ? q16_image::load(&fs, store, &state)
+        : gfx::jpeg_image::load(&fs, store, &state);
+    fs.close();
+
+    if(res == gfx::gfx_result::out_of_memory) {
+        ESP_LOGW(TAG_RENDER, "No memory to prefetch %s.", path);
+        return RENDER_ERR_NO_MEM;
+    }
+    if(res != gfx::gfx_result::success || !state.allocated) {
+        ESP_LOGE(TAG_RENDER, "Cannot decode %s.", path);
+        return RENDER_ERR_DRAW;
+    }
+    return RENDER_OK;
+}
+
+void image_prefetcher::release(buffer &b) {
+    if(b.image != nullptr) {
+        b.image->~bitmap_type();
+        b.image = nullptr;
+    }
+    if(b.pixels != nullptr) {
+        heap_caps_free(b.pixels);
+        b.pixels = nullptr;
+    }
+    b.size = 0;
+}
+
+} // namespace bcd_render
@@ -0,0 +1,83 @@
+#include "../include/bcd_indexed_surface.hpp"
+#include <string.h>
+
+namespace bcd_render {
+
+render_err_t indexed_surface::initialize(const gfx::size16 &dimensions) {
+    deinitialize();
+    stride = (dimensions.width + 1) / 2;
+    pixels = (uint8_t *)heap_caps_calloc(stride * dimensions.height, 1,
+        MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(pixels == nullptr) {
+        ESP_LOGE(TAG_RENDER, "No memory for %ux%u indexed surface.",
+            dimensions.width, dimensions.height);
+        stride = 0;
+        return RENDER_ERR_NO_MEM;
+    }
+    size = dimensions;
+    return RENDER_OK;
+}
+
+void indexed_surface::deinitialize() {
+    if(pixels != nullptr) {
+        heap_caps_free(pixels);
+        pixels = nullptr;
+    }
+    size = gfx::size16(0, 0);
+}
+
+void indexed_surface::fill(const gfx::rect16 &r, uint8_t index) {
+    if(pixels == nullptr || !bounds().intersects(r)) {
+        return;
+    }
+    gfx::rect16 c = r.normalize().crop(bounds());
+    index &= 0x0f;
+    uint8_t both = (index << 4) | index;
+    for(uint16_t y = c.top(); y <= c.bottom(); y++) {
+        uint8_t *row = pixels + y * stride;
+        uint16_t x = c.left();
+        if(x & 1) {
+            row[x / 2] = (row[x / 2] & 0xf0) | index;
+            x++;
+        }
+        // Whole bytes in the middle
+        uint16_t end = c.right() + 1;
+        if(end > x + 1) {
+            size_t bytes = (end - x) / 2;
+            memset(row + x / 2, both, bytes);
+            x += bytes * 2;
+        }
+        if(x < end) {
+            row[x / 2] = (row[x / 2] & 0x0f) | (index << 4);
+        }
+    }
+}
+
+void indexed_surface::rectangle(const gfx::rect16 &r, uint8_t index) {
+    gfx::rect16 n = r.normalize();
+    fill(gfx::rect16(n.left(), n.top(), n.right(), n.top()), index);
+    fill(gfx::rect16(n.left(), n.bottom(), n.right(), n.bottom()), index);
+    fill(gfx::rect16(n.left(), n.top(), n.left(), n.bottom()), index);
+    fill(gfx::rect16(n.right(), n.top(), n.right(), n.bottom()), index);
+}
+
+void indexed_surface::expand(uint16_t x, uint16_t y, uint16_t width,
+        const indexed_palette &palette, uint8_t *out) const {
+    const uint8_t *row = pixels + y * stride;
+    uint16_t *o = (uint16_t *)out;
+    uint16_t end = x + width;
+    if(x & 1) {
+        *o++ = palette[row[x / 2] & 0x0f];
+        x++;
+    }
+    for(; x + 1 < end; x += 2) {
+        uint8_t b = row[x / 2];
+        *o++ = palette[b >> 4];
+        *o++ = palette[b & 0x0f];
+    }
+    if(x < end) {
+        *o = palette[row[x / 2] >> 4];
+    }
+}
+
+} // namespace bcd_render
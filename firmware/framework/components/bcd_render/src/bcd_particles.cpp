@@ -0,0 +1,87 @@
+#include "../include/bcd_particles.hpp"
+
+namespace bcd_render {
+
+size_t particle_system::emit(const gfx::srect16 &area, size_t amount,
+        pixel_type tint, int16_t spread, int16_t lift, uint16_t lifetime) {
+    if(lifetime == 0) {
+        return 0;
+    }
+    const gfx::srect16 a = area.normalize();
+    const uint32_t width = a.width();
+    const uint32_t height = a.height();
+    const uint32_t range = 2 * spread + 1;
+    size_t started = 0;
+    for(; started < amount && count < capacity; started++) {
+        size_t i = count++;
+        x[i] = (a.left() << 8) + random() % (width << 8);
+        y[i] = (a.top() << 8) + random() % (height << 8);
+        vx[i] = (int32_t)(random() % range) - spread;
+        vy[i] = (int32_t)(random() % range) - spread - lift;
+        life[i] = lifetime - random() % (lifetime / 4 + 1);
+        color[i] = tint;
+    }
+    return started;
+}
+
+void particle_system::update(int64_t now) {
+    if(last == 0 || now < last) {
+        last = now;
+        return;
+    }
+    carry += now - last;
+    last = now;
+    uint32_t steps = carry / stepUs;
+    carry %= stepUs;
+    if(steps > maxSteps) {
+        steps = maxSteps;
+    }
+
+    const int32_t left = bounds.left() << 8;
+    const int32_t top = bounds.top() << 8;
+    const int32_t right = (bounds.right() + 1) << 8;
+    const int32_t bottom = (bounds.bottom() + 1) << 8;
+    for(uint32_t s = 0; s < steps; s++) {
+        for(size_t i = 0; i < count;) {
+            if(vy[i] < INT16_MAX - fall) {
+                vy[i] += fall;
+            }
+            x[i] += vx[i];
+            y[i] += vy[i];
+            if(--life[i] == 0 || x[i] < left || x[i] >= right || y[i] < top
+                    || y[i] >= bottom) {
+                // The last particle moves here and is handled next
+                remove(i);
+                continue;
+            }
+            i++;
+        }
+    }
+}
+
+void particle_system::clear() {
+    count = 0;
+    shownCount = 0;
+    carry = 0;
+    last = 0;
+}
+
+// xorshift32, good enough to scatter pixels
+uint32_t particle_system::random() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+void particle_system::remove(size_t i) {
+    count--;
+    x[i] = x[count];
+    y[i] = y[count];
+    vx[i] = vx[count];
+    vy[i] = vy[count];
+    life[i] = life[count];
+    color[i] = color[count];
+}
+
+} // namespace bcd_render
@@ -0,0 +1,147 @@
+#include "../include/bcd_q16.hpp"
+#include <string.h>
+#include "esp_heap_caps.h"
+
+namespace bcd_render {
+
+namespace {
+
+// Reads the stream in blocks, streams on SPIFFS are slow per call
+class reader {
+    public:
+        reader(gfx::stream *in) : in(in) {}
+
+        int next() {
+            if(pos == len) {
+                len = in->read(buffer, sizeof(buffer));
+                pos = 0;
+                if(len == 0) {
+                    return -1;
+                }
+            }
+            return buffer[pos++];
+        }
+
+    private:
+        gfx::stream *in;
+        uint8_t buffer[256];
+        size_t pos = 0;
+        size_t len = 0;
+};
+
+inline uint8_t hash(uint16_t px) {
+    return ((px >> 11) * 3 + ((px >> 5) & 0x3f) * 5 + (px & 0x1f) * 7) & 0x3f;
+}
+
+inline uint16_t pack(int r, int g, int b) {
+    return ((r & 0x1f) << 11) | ((g & 0x3f) << 5) | (b & 0x1f);
+}
+
+} // namespace
+
+gfx::gfx_result q16_image::load(gfx::stream *in, callback_type callback,
+        void *state) {
+    reader r(in);
+    uint8_t header[8];
+    for(size_t i = 0; i < sizeof(header); i++) {
+        int c = r.next();
+        if(c < 0) {
+            return gfx::gfx_result::invalid_format;
+        }
+        header[i] = c;
+    }
+    if(memcmp(header, "Q16I", 4) != 0) {
+        return gfx::gfx_result::invalid_format;
+    }
+    const gfx::size16 dimensions(header[4] | (header[5] << 8),
+        header[6] | (header[7] << 8));
+
+    size_t bytes = region_type::sizeof_buffer(
+        gfx::size16(dimensions.width, stripHeight));
+    uint8_t *strip = (uint8_t *)heap_caps_malloc(bytes, MALLOC_CAP_DMA);
+    if(strip == nullptr) {
+        strip = (uint8_t *)heap_caps_malloc(bytes, MALLOC_CAP_8BIT);
+    }
+    if(strip == nullptr) {
+        return gfx::gfx_result::out_of_memory;
+    }
+
+    gfx::gfx_result result = gfx::gfx_result::success;
+    uint16_t index[64] = { 0 };
+    uint16_t px = 0;
+    int run = 0;
+    for(uint16_t y = 0; y < dimensions.height
+            && result == gfx::gfx_result::success; y += stripHeight) {
+        uint16_t rows = dimensions.height - y < stripHeight
+            ? dimensions.height - y : stripHeight;
+        uint8_t *out = strip;
+        for(size_t i = dimensions.width * rows; i > 0; i--) {
+            if(run > 0) {
+                run--;
+            } else {
+                int op = r.next();
+                if(op < 0) {
+                    result = gfx::gfx_result::invalid_format;
+                    break;
+                }
+                switch(op >> 6) {
+                    case 0:
+                        px = index[op];
+                        break;
+                    case 1:
+                        px = pack((px >> 11) + ((op >> 4) & 3) - 2,
+                            ((px >> 5) & 0x3f) + ((op >> 2) & 3) - 2,
+                            (px & 0x1f) + (op & 3) - 2);
+                        break;
+                    case 2: {
+                        int rb = r.next();
+                        if(rb < 0) {
+                            result = gfx::gfx_result::invalid_format;
+                        }
+                        int dg = (op & 0x3f) - 32;
+                        px = pack((px >> 11) + dg + (rb >> 4) - 8,
+                            ((px >> 5) & 0x3f) + dg,
+                            (px & 0x1f) + dg + (rb & 0x0f) - 8);
+                        break;
+                    }
+                    default:
+                        if(op == 0xfe) {
+                            int hi = r.next();
+                            int lo = r.next();
+                            if(lo < 0) {
+                                result = gfx::gfx_result::invalid_format;
+                            }
+                            px = (hi << 8) | (lo & 0xff);
+                        } else if(op == 0xff) {
+                            result = gfx::gfx_result::invalid_format;
+                        } else {
+                            run = op & 0x3f;
+                        }
+                        break;
+                }
+                if(result != gfx::gfx_result::success) {
+                    break;
+                }
+                index[hash(px)] = px;
+            }
+            // Framebuffer byte order
+            *out++ = px >> 8;
+            *out++ = px & 0xff;
+        }
+        if(result != gfx::gfx_result::success) {
+            break;
+        }
+        region_type region(gfx::size16(dimensions.width, rows), strip);
+        result = callback(dimensions, region, gfx::point16(0, y), state);
+    }
+
+    heap_caps_free(strip);
+    return result;
+}
+
+bool q16_image::matches(const char *path) {
+    size_t len = strlen(path);
+    return len > 4 && strcmp(path + len - 4, ".q16") == 0;
+}
+
+} // namespace bcd_render
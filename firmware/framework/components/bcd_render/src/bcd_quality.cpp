@@ -0,0 +1,74 @@
+#include "../include/bcd_quality.hpp"
+
+namespace bcd_render {
+
+// Frames the average gets to follow a step down before the next one
+static constexpr uint16_t SETTLE_FRAMES = 8;
+
+void quality_governor::reset() {
+    stats = quality_stats();
+    average = 0;
+    settle = 0;
+    calm = 0;
+}
+
+void quality_governor::update(const frame_clock &clock) {
+    const uint32_t dropped = clock.dropped() - lastDropped;
+    lastDropped = clock.dropped();
+    if(stats.frames++ == 0 || clock.period() == 0) {
+        return;
+    }
+
+    uint32_t load = (uint64_t)clock.busy() * 100 / clock.period();
+    if(load > UINT16_MAX) {
+        load = UINT16_MAX;
+    }
+    if(load > stats.peak) {
+        stats.peak = load;
+    }
+    if(load > 100) {
+        stats.overruns++;
+    }
+    // Moving average over about 8 frames
+    average = average + ((int32_t)(load * 16) - (int32_t)average) / 8;
+    stats.load = average / 16;
+    if(stats.level != quality_e::FULL) {
+        stats.reduced++;
+    }
+
+    if(settle > 0) {
+        settle--;
+    }
+    if((stats.load > CONFIG_RENDER_QUALITY_HIGH_LOAD || dropped > 0)
+            && settle == 0) {
+        calm = 0;
+        if(stats.level != quality_e::MINIMAL) {
+            change((quality_e)((uint8_t)stats.level + 1));
+            stats.downgrades++;
+            settle = SETTLE_FRAMES;
+        }
+        return;
+    }
+
+    if(stats.load >= CONFIG_RENDER_QUALITY_LOW_LOAD) {
+        calm = 0;
+        return;
+    }
+    if(++calm >= CONFIG_RENDER_QUALITY_RECOVER
+            && stats.level != quality_e::FULL) {
+        change((quality_e)((uint8_t)stats.level - 1));
+        stats.upgrades++;
+        calm = 0;
+    }
+}
+
+void quality_governor::change(quality_e level) {
+#ifdef CONFIG_RENDER_LOG_STATS
+    ESP_LOGI(TAG_RENDER, "quality %u -> %u at %u%% load (peak %u%%)",
+        (unsigned)stats.level, (unsigned)level, (unsigned)stats.load,
+        (unsigned)stats.peak);
+#endif
+    stats.level = level;
+}
+
+} // namespace bcd_render
@@ -0,0 +1,376 @@
+#include "../include/bcd_rgb565.hpp"
+#include <string.h>
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+namespace bcd_render {
+namespace rgb565 {
+
+// Blends n pixels in a row with the colour's share f already weighted
+static inline void blendPixels(uint8_t *p, uint16_t n, uint32_t f,
+        uint32_t keep) {
+    for(; n > 0; n--, p += 2) {
+        const uint32_t v = (p[0] << 8) | p[1];
+        const uint32_t b = (v | (v << 16)) & 0x07e0f81f;
+        const uint32_t m = ((f + b * keep) >> 5) & 0x07e0f81f;
+        const uint16_t out = m | (m >> 16);
+        p[0] = out >> 8;
+        p[1] = out & 0xff;
+    }
+}
+
+// Blends n pixels through their alpha, f is the colour spread like b
+static inline void blendMaskPixels(uint8_t *p, ptrdiff_t step,
+        const uint8_t *mask, uint16_t n, uint16_t color, uint32_t f) {
+    for(uint16_t i = 0; i < n; i++, p += step) {
+        // Most of a glyph is either empty or solid
+        const uint32_t a = (mask[i] + 4) >> 3;
+        if(a == 0) {
+            continue;
+        }
+        if(a == 32) {
+            p[0] = color >> 8;
+            p[1] = color & 0xff;
+            continue;
+        }
+        const uint32_t v = (p[0] << 8) | p[1];
+        const uint32_t b = (v | (v << 16)) & 0x07e0f81f;
+        const uint32_t m = ((f * a + b * (32 - a)) >> 5) & 0x07e0f81f;
+        const uint16_t out = m | (m >> 16);
+        p[0] = out >> 8;
+        p[1] = out & 0xff;
+    }
+}
+
+#if CONFIG_IDF_TARGET_ESP32S3
+// The PIE vector unit of the ESP32-S3 blends eight pixels per instruction in
+// 16 bit lanes. It has no 32 bit multiply for the spread pixels above, so
+// every channel gets a lane of its own, at a position where its product
+// with a 5 bit alpha fits 16 bits. EE.VMUL.U16 shifts every product right
+// by SAR, which is 5 throughout. The results are the same as the scalar
+// kernels'.
+
+// Vectors of the colour and of the masks and factors used on the lanes, in
+// the order BLEND_LANES reads them
+struct alignas(16) pie_color {
+    uint16_t v[12][8];
+};
+
+// Alpha and 32 - alpha of a block of 16 pixels, in two halves
+struct alignas(16) pie_weights {
+    uint16_t v[4][8];
+};
+
+static void pieColor(pie_color &k, uint16_t color) {
+    const uint16_t values[12] = {
+        // Green mask, green << 5
+        0x07e0, (uint16_t)(color & 0x07e0), 0x07e0,
+        // Blue mask, 1024 to turn keep into keep << 5, blue << 5, 1
+        0x001f, 1024, (uint16_t)((color & 0x001f) << 5), 1,
+        // Red mask, 16 for a shift by one, red << 10, its sum mask, 64
+        0xf800, 16, (uint16_t)((color & 0xf800) >> 1), 0x7c00, 64,
+    };
+    for(int i = 0; i < 12; i++) {
+        for(int j = 0; j < 8; j++) {
+            k.v[i][j] = values[i];
+        }
+    }
+}
+
+static void pieWeights(pie_weights &w, const uint8_t *mask) {
+    for(int i = 0; i < 16; i++) {
+        const uint16_t a = (mask[i] + 4) >> 3;
+        w.v[(i / 8) * 2][i % 8] = a;
+        w.v[(i / 8) * 2 + 1][i % 8] = 32 - a;
+    }
+}
+
+// Blends the 8 pixels in lane register V with alpha in q5 and 32 - alpha in
+// q6. The channels are taken apart and put back with masks, the shifts are
+// multiplies. With G, B, R of the pixel and g, b, r of the colour:
+//      G: (G << 5) * keep >> 5 plus (g << 5) * a >> 5, masked to G << 5
+//      B: B * (keep << 5) >> 5 plus (b << 5) * a >> 5, times 1 >> 5
+//      R: (R << 10) * keep >> 5 plus (r << 10) * a >> 5 is the sum << 5,
+//         masked to 0x7c00 and times 64 >> 5 it is R << 11
+#define BLEND_LANES(V) \
+    "mov %[t], %[k]\n" \
+    "ee.vld.128.ip q3, %[t], 16\n" \
+    "ee.andq q2, " V ", q3\n" \
+    "ee.vmul.u16 q2, q2, q6\n" \
+    "ee.vld.128.ip q3, %[t], 16\n" \
+    "ee.vmul.u16 q3, q3, q5\n" \
+    "ee.vadds.s16 q2, q2, q3\n" \
+    "ee.vld.128.ip q3, %[t], 16\n" \
+    "ee.andq q2, q2, q3\n" \
+    "ee.vld.128.ip q3, %[t], 16\n" \
+    "ee.andq q3, " V ", q3\n" \
+    "ee.vld.128.ip q4, %[t], 16\n" \
+    "ee.vmul.u16 q4, q6, q4\n" \
+    "ee.vmul.u16 q3, q3, q4\n" \
+    "ee.vld.128.ip q4, %[t], 16\n" \
+    "ee.vmul.u16 q4, q4, q5\n" \
+    "ee.vadds.s16 q3, q3, q4\n" \
+    "ee.vld.128.ip q4, %[t], 16\n" \
+    "ee.vmul.u16 q3, q3, q4\n" \
+    "ee.orq q2, q2, q3\n" \
+    "ee.vld.128.ip q3, %[t], 16\n" \
+    "ee.andq q3, " V ", q3\n" \
+    "ee.vld.128.ip q4, %[t], 16\n" \
+    "ee.vmul.u16 q3, q3, q4\n" \
+    "ee.vmul.u16 q3, q3, q6\n" \
+    "ee.vld.128.ip q4, %[t], 16\n" \
+    "ee.vmul.u16 q4, q4, q5\n" \
+    "ee.vadds.s16 q3, q3, q4\n" \
+    "ee.vld.128.ip q4, %[t], 16\n" \
+    "ee.andq q3, q3, q4\n" \
+    "ee.vld.128.ip q4, %[t], 16\n" \
+    "ee.vmul.u16 q3, q3, q4\n" \
+    "ee.orq " V ", q2, q3\n"
+
+// Blends blocks of 16 pixels, p must be 16 byte aligned. Every block reads
+// the next weights, a rewind of -sizeof(pie_weights) keeps the same.
+static void pieBlend(uint8_t *p, size_t blocks, const pie_weights *w,
+        int rewind, const pie_color &k) {
+    const uint16_t *t;
+    asm volatile(
+        "ssai 5\n"
+        "0:\n"
+        "ee.vld.128.ip q0, %[p], 16\n"
+        "ee.vld.128.ip q1, %[p], -16\n"
+        // Pixels are stored high byte first. Split the bytes and zip them
+        // the other way round, so q1 has pixels 0 - 7 and q0 8 - 15 as
+        // 16 bit values.
+        "ee.vunzip.8 q0, q1\n"
+        "ee.vzip.8 q1, q0\n"
+        "ee.vld.128.ip q5, %[w], 16\n"
+        "ee.vld.128.ip q6, %[w], 16\n"
+        BLEND_LANES("q1")
+        "ee.vld.128.ip q5, %[w], 16\n"
+        "ee.vld.128.ip q6, %[w], 16\n"
+        BLEND_LANES("q0")
+        "add %[w], %[w], %[rewind]\n"
+        // And back to high byte first
+        "ee.vunzip.8 q1, q0\n"
+        "ee.vzip.8 q0, q1\n"
+        "ee.vst.128.ip q0, %[p], 16\n"
+        "ee.vst.128.ip q1, %[p], 16\n"
+        "addi %[n], %[n], -1\n"
+        "bnez %[n], 0b\n"
+        : [p] "+r"(p), [w] "+r"(w), [n] "+r"(blocks), [t] "=&r"(t)
+        : [k] "r"(k.v), [rewind] "r"(rewind)
+        : "memory");
+}
+
+#undef BLEND_LANES
+
+// Pixels up to the first 16 byte boundary, all of them if p is not even
+// 16 bit aligned
+static inline uint16_t pieHead(const uint8_t *p, uint16_t n) {
+    if((uintptr_t)p & 1) {
+        return n;
+    }
+    const uint16_t head = ((16 - ((uintptr_t)p & 15)) & 15) / 2;
+    return head < n ? head : n;
+}
+#endif //CONFIG_IDF_TARGET_ESP32S3
+
+void fill(uint8_t *base, size_t stride, uint16_t x, uint16_t y,
+        uint16_t width, uint16_t height, uint16_t color) {
+    const uint8_t hi = color >> 8;
+    const uint8_t lo = color & 0xff;
+    // Two pixels in memory order, whatever the byte order of the CPU
+    const uint8_t pair[4] = { hi, lo, hi, lo };
+    uint32_t word;
+    memcpy(&word, pair, sizeof(word));
+
+    uint8_t *row = base + y * stride + x * 2;
+    for(uint16_t r = 0; r < height; r++, row += stride) {
+        uint8_t *p = row;
+        uint16_t n = width;
+        if((uintptr_t)p & 1) {
+            // Not even 16 bit aligned, no word stores possible
+            for(; n > 0; n--, p += 2) {
+                p[0] = hi;
+                p[1] = lo;
+            }
+            continue;
+        }
+        if(((uintptr_t)p & 3) && n > 0) {
+            p[0] = hi;
+            p[1] = lo;
+            p += 2;
+            n--;
+        }
+        uint32_t *w = (uint32_t *)p;
+        size_t words = n / 2;
+        for(; words >= 4; words -= 4, w += 4) {
+            w[0] = word;
+            w[1] = word;
+            w[2] = word;
+            w[3] = word;
+        }
+        for(; words > 0; words--) {
+            *w++ = word;
+        }
+        if(n & 1) {
+            p = (uint8_t *)w;
+            p[0] = hi;
+            p[1] = lo;
+        }
+    }
+}
+
+void copy(uint8_t *destination, size_t destinationStride,
+        const uint8_t *source, size_t sourceStride, uint16_t width,
+        uint16_t height) {
+    const size_t bytes = width * 2;
+    if(bytes == destinationStride && bytes == sourceStride) {
+        // Full rows on both sides are one block
+        memcpy(destination, source, bytes * height);
+        return;
+    }
+    for(uint16_t r = 0; r < height; r++) {
+        memcpy(destination, source, bytes);
+        destination += destinationStride;
+        source += sourceStride;
+    }
+}
+
+void copy_strided(uint8_t *destination, ptrdiff_t destinationX,
+        ptrdiff_t destinationY, const uint8_t *source, ptrdiff_t sourceX,
+        ptrdiff_t sourceY, uint16_t width, uint16_t height) {
+    for(uint16_t r = 0; r < height; r++) {
+        uint8_t *d = destination;
+        const uint8_t *s = source;
+        for(uint16_t n = 0; n < width; n++) {
+            d[0] = s[0];
+            d[1] = s[1];
+            d += destinationX;
+            s += sourceX;
+        }
+        destination += destinationY;
+        source += sourceY;
+    }
+}
+
+size_t pack444(uint8_t *out, const uint8_t *source, size_t sourceStride,
+        uint16_t width, uint16_t height) {
+    uint8_t *start = out;
+    // 12 bits of a pixel waiting for the next one to fill the third byte
+    uint16_t pending = 0;
+    bool odd = false;
+    for(uint16_t r = 0; r < height; r++, source += sourceStride) {
+        const uint8_t *p = source;
+        for(uint16_t n = 0; n < width; n++, p += 2) {
+            // RRRRRGGG GGGBBBBB to RRRRGGGGBBBB
+            const uint16_t v = (p[0] << 8) | p[1];
+            const uint16_t c = ((v >> 4) & 0xf00) | ((v >> 3) & 0x0f0)
+                | ((v >> 1) & 0x00f);
+            if(!odd) {
+                pending = c;
+            } else {
+                out[0] = pending >> 4;
+                out[1] = ((pending & 0x0f) << 4) | (c >> 8);
+                out[2] = c & 0xff;
+                out += 3;
+            }
+            odd = !odd;
+        }
+    }
+    if(odd) {
+        out[0] = pending >> 4;
+        out[1] = (pending & 0x0f) << 4;
+        out += 2;
+    }
+    return out - start;
+}
+
+void blend(uint8_t *base, size_t stride, uint16_t x, uint16_t y,
+        uint16_t width, uint16_t height, uint16_t color, uint8_t alpha) {
+    const uint32_t a = (alpha + 4) >> 3;
+    if(a == 0) {
+        return;
+    }
+    if(a == 32) {
+        fill(base, stride, x, y, width, height, color);
+        return;
+    }
+    // The colour's share is the same for every pixel
+    const uint32_t f = ((color | ((uint32_t)color << 16)) & 0x07e0f81f) * a;
+    const uint32_t keep = 32 - a;
+
+#if CONFIG_IDF_TARGET_ESP32S3
+    pie_color k;
+    pieColor(k, color);
+    pie_weights w;
+    for(int i = 0; i < 4; i++) {
+        for(int j = 0; j < 8; j++) {
+            w.v[i][j] = i & 1 ? keep : a;
+        }
+    }
+#endif
+
+    uint8_t *row = base + y * stride + x * 2;
+    for(uint16_t r = 0; r < height; r++, row += stride) {
+        uint8_t *p = row;
+        uint16_t n = width;
+#if CONFIG_IDF_TARGET_ESP32S3
+        const uint16_t head = pieHead(p, n);
+        blendPixels(p, head, f, keep);
+        p += head * 2;
+        n -= head;
+        if(n >= 16) {
+            pieBlend(p, n / 16, &w, -(int)sizeof(w), k);
+            p += (n & ~15) * 2;
+            n &= 15;
+        }
+#endif
+        blendPixels(p, n, f, keep);
+    }
+}
+
+void blend_mask(uint8_t *destination, ptrdiff_t destinationX,
+        ptrdiff_t destinationY, const uint8_t *mask, size_t maskStride,
+        uint16_t width, uint16_t height, uint16_t color) {
+    const uint32_t f = (color | ((uint32_t)color << 16)) & 0x07e0f81f;
+#if CONFIG_IDF_TARGET_ESP32S3
+    pie_color k;
+    if(destinationX == 2) {
+        pieColor(k, color);
+    }
+#endif
+    for(uint16_t r = 0; r < height; r++) {
+        uint8_t *p = destination;
+        const uint8_t *m = mask;
+        uint16_t n = width;
+#if CONFIG_IDF_TARGET_ESP32S3
+        // Only rows that run along memory can be loaded as vectors, not
+        // the columns of a rotated view
+        if(destinationX == 2) {
+            const uint16_t head = pieHead(p, n);
+            blendMaskPixels(p, 2, m, head, color, f);
+            p += head * 2;
+            m += head;
+            n -= head;
+            pie_weights w[8];
+            while(n >= 16) {
+                size_t blocks = n / 16 < 8 ? n / 16 : 8;
+                for(size_t i = 0; i < blocks; i++) {
+                    pieWeights(w[i], m + i * 16);
+                }
+                pieBlend(p, blocks, w, 0, k);
+                p += blocks * 32;
+                m += blocks * 16;
+                n -= blocks * 16;
+            }
+        }
+#endif
+        blendMaskPixels(p, destinationX, m, n, color, f);
+        destination += destinationY;
+        mask += maskStride;
+    }
+}
+
+} // namespace rgb565
+} // namespace bcd_render
@@ -0,0 +1,29 @@
+#include "../include/bcd_row_diff.hpp"
+#include "esp_heap_caps.h"
+
+namespace bcd_render {
+
+render_err_t row_diff::initialize(uint16_t rows) {
+    deinitialize();
+    crcs = (uint32_t *)heap_caps_malloc(rows * sizeof(uint32_t),
+        MALLOC_CAP_8BIT);
+    if(crcs == nullptr) {
+        ESP_LOGW(TAG_RENDER, "No memory for row checksums. Sending whole "
+            "bitmaps.");
+        return RENDER_ERR_NO_MEM;
+    }
+    this->rows = rows;
+    valid = false;
+    return RENDER_OK;
+}
+
+void row_diff::deinitialize() {
+    if(crcs != nullptr) {
+        heap_caps_free(crcs);
+        crcs = nullptr;
+    }
+    rows = 0;
+    valid = false;
+}
+
+} // namespace bcd_render
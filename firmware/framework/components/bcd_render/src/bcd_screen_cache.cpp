@@ -0,0 +1,51 @@
+#include "../include/bcd_screen_cache.hpp"
+
+namespace bcd_render {
+
+void screen_cache::clear() {
+    for(entry &e : entries) {
+        drop(e);
+    }
+}
+
+render_err_t screen_cache::reserve(entry &e, gfx::size16 dimensions) {
+    e.composed = false;
+    const size_t size = bitmap_type::sizeof_buffer(dimensions);
+    if(e.pixels != nullptr && e.size == size) {
+        e.image->~bitmap_type();
+        e.image = new (&e.imageStorage) bitmap_type(dimensions, e.pixels);
+        return RENDER_OK;
+    }
+    drop(e);
+
+    // Screens are only read by blits, so PSRAM is fast enough
+    uint8_t *pixels = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if(pixels == nullptr) {
+        pixels = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    if(pixels == nullptr) {
+        ESP_LOGW(TAG_RENDER, "No memory for a %ux%u screen.",
+            dimensions.width, dimensions.height);
+        return RENDER_ERR_NO_MEM;
+    }
+    e.pixels = pixels;
+    e.size = size;
+    e.image = new (&e.imageStorage) bitmap_type(dimensions, pixels);
+    bytes += size;
+    return RENDER_OK;
+}
+
+void screen_cache::drop(entry &e) {
+    if(e.pixels == nullptr) {
+        return;
+    }
+    e.image->~bitmap_type();
+    e.image = nullptr;
+    heap_caps_free(e.pixels);
+    e.pixels = nullptr;
+    e.composed = false;
+    bytes -= e.size;
+    e.size = 0;
+}
+
+} // namespace bcd_render
@@ -0,0 +1,126 @@
+#include "../include/bcd_timeline.hpp"
+
+namespace bcd_render {
+
+static constexpr int32_t ONE = 1 << 16;
+
+// Handles carry the generation of their slot, so a handle to a finished
+// tween does not match a new tween in the same slot.
+static tween_handle makeHandle(size_t slot, uint8_t generation) {
+    return ((tween_handle)generation << 8) | slot;
+}
+
+tween_handle timeline::start(int32_t *value, int32_t from, int32_t to,
+        uint32_t durationUs, ease curve, uint32_t delayUs) {
+    for(size_t i = 0; i < capacity; i++) {
+        tween &t = tweens[i];
+        if(t.used) {
+            continue;
+        }
+        t.value = value;
+        t.from = from;
+        t.to = to;
+        t.start = now + delayUs;
+        t.duration = durationUs > 0 ? durationUs : 1;
+        t.curve = curve;
+        t.generation++;
+        t.used = true;
+        return makeHandle(i, t.generation);
+    }
+    ESP_LOGW(TAG_RENDER, "All %u tweens in use.", (unsigned)capacity);
+    return RENDER_NO_TWEEN;
+}
+
+void timeline::update(int64_t nowUs) {
+    now = nowUs;
+    for(size_t i = 0; i < capacity; i++) {
+        tween &t = tweens[i];
+        if(!t.used || now < t.start) {
+            continue;
+        }
+        int64_t elapsed = now - t.start;
+        if(elapsed >= t.duration) {
+            *t.value = endValue(t);
+            t.used = false;
+            continue;
+        }
+        int32_t progress = (int32_t)((elapsed << 16) / t.duration);
+        int32_t eased = apply(t.curve, progress);
+        *t.value = t.from + (int32_t)(((int64_t)(t.to - t.from) * eased) >> 16);
+    }
+}
+
+bool timeline::active(tween_handle h) const {
+    return find(h) != nullptr;
+}
+
+void timeline::cancel(tween_handle h, bool finish) {
+    tween *t = find(h);
+    if(t == nullptr) {
+        return;
+    }
+    if(finish) {
+        *t->value = endValue(*t);
+    }
+    t->used = false;
+}
+
+void timeline::clear() {
+    for(size_t i = 0; i < capacity; i++) {
+        tweens[i].used = false;
+    }
+}
+
+size_t timeline::size() const {
+    size_t n = 0;
+    for(size_t i = 0; i < capacity; i++) {
+        if(tweens[i].used) {
+            n++;
+        }
+    }
+    return n;
+}
+
+int32_t timeline::apply(ease curve, int32_t t) {
+    switch(curve) {
+        case ease::LINEAR:
+            return t;
+        case ease::IN:
+            return (int32_t)(((int64_t)t * t) >> 16);
+        case ease::OUT: {
+            int32_t r = ONE - t;
+            return ONE - (int32_t)(((int64_t)r * r) >> 16);
+        }
+        case ease::IN_OUT:
+            if(t < ONE / 2) {
+                return (int32_t)(((int64_t)t * t) >> 15);
+            } else {
+                int32_t r = ONE - t;
+                return ONE - (int32_t)(((int64_t)r * r) >> 15);
+            }
+        case ease::PULSE:
+            return apply(ease::IN_OUT, t < ONE / 2 ? 2 * t : 2 * (ONE - t));
+    }
+    return t;
+}
+
+timeline::tween *timeline::find(tween_handle h) {
+    return const_cast<tween *>(static_cast<const timeline *>(this)->find(h));
+}
+
+const timeline::tween *timeline::find(tween_handle h) const {
+    if(h < 0 || (size_t)(h & 0xff) >= capacity) {
+        return nullptr;
+    }
+    const tween &t = tweens[h & 0xff];
+    if(!t.used || t.generation != (uint8_t)(h >> 8)) {
+        return nullptr;
+    }
+    return &t;
+}
+
+int32_t timeline::endValue(const tween &t) {
+    return t.curve == ease::PULSE ? t.from : t.to;
+}
+
+} // namespace bcd_render
@@ -0,0 +1,499 @@
+/**
+ * @file    mod_benchmark.hpp
+ * @brief   Display throughput benchmark
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Measures how fast a display can be drawn to: clears, filled rectangles of
+ * several sizes, bitmaps from internal RAM and PSRAM, text with draw::text
+ * and from the glyph cache, and JPEG and q16 decoding.
+ * Translucent overlays are blended over a whole frame in internal RAM and in
+ * PSRAM with bcd_render::blend(), without the display, so their ms/frame is
+ * the time a full screen overlay costs the CPU (with the PIE kernel on the
+ * ESP32-S3, see bcd_rgb565.cpp).
+ * Frames composed in a display list are flushed twice: once through the
+ * driver, which rotates every write, and once in the panel's native order
+ * (see bcd_display_list.hpp).
+ * Every case reports its throughput in pixels per second and the time a full
+ * screen of it would take, so buffer sizes (SPI_BUFFER_SIZE) and render
+ * strategies can be chosen with data. With the esp_lcd backend, which reports
+ * the time it spends blocked on the bus, the share of the run time the CPU
+ * was busy is listed too.
+ *
+ * The benchmark draws directly on the display. Results are only meaningful
+ * if nothing else draws at the same time.
+ *
+ * Usage:
+ *      bcd_benchmark::configure(lcd, font);
+ *      // From a menu
+ *      mc.createActionItem("Benchmark", bcd_benchmark::module_main<lcd_type>,
+ *          &lcd);
+ *      // From the console
+ *      console.registerCommand("benchmark", &bcd_benchmark::command<lcd_type>,
+ *          "Measure display throughput.");
+ */
+#pragma once
+
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <string.h>
+#include <new>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "gfx.hpp"
+#include "bcd_q16.hpp"
+#include "bcd_glyph_cache.hpp"
+#include "bcd_display_list.hpp"
+#include "bcd_esp_lcd.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Menuconfig options
+////////////////////////////////////////////////////////////////////////////////
+#define TAG_MOD_BENCHMARK CONFIG_TAG_MOD_BENCHMARK
+
+// Rotation of the display driver, for the display list cases
+#ifdef CONFIG_LCD_ROTATION
+#define BENCHMARK_ROTATION CONFIG_LCD_ROTATION
+#else
+#define BENCHMARK_ROTATION 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Error handling
+////////////////////////////////////////////////////////////////////////////////
+typedef BaseType_t benchmark_err_t;
+
+#define BENCHMARK_FAIL              -1                                          /**< Generic failure */
+#define BENCHMARK_OK                0x000                                       /**< All good */
+#define BENCHMARK_ERR_NOT_CONFIGURED 0x101                                      /**< configure() not called */
+#define BENCHMARK_ERR_NO_MEM        0x102                                       /**< Could not allocate test bitmap */
+
+namespace bcd_benchmark {
+
+#define BENCHMARK_MAX_RESULTS       24
+
+struct result {
+    char name[20];                                                              /**< Case name */
+    uint32_t pixels = 0;                                                        /**< Pixels per operation */
+    uint32_t ops = 0;                                                           /**< Operations run */
+    int64_t us = 0;                                                             /**< Total run time */
+    int64_t waitUs = -1;                                                        /**< Blocked on the bus, -1 if unknown */
+};
+
+/**
+ * @brief Prints results as a table to the console
+ */
+void print(const result *results, size_t count, uint32_t framePixels);
+
+/**
+ * @brief Formats a result as a short line for the display
+ */
+void format(const result &r, uint32_t framePixels, char *buf, size_t size);
+
+template<typename Destination>
+class benchmark {
+    public:
+        using pixel_type = typename Destination::pixel_type;
+        using bitmap_type = gfx::bitmap<pixel_type>;
+
+        benchmark(Destination &display, const gfx::font &font,
+                const char *jpegPath, const char *q16Path)
+            : display(display), font(font), jpegPath(jpegPath),
+              q16Path(q16Path) {}
+
+        /**
+         * @brief Runs all cases
+         *
+         * @param results Receives up to BENCHMARK_MAX_RESULTS results
+         * @return Number of results
+         */
+        size_t run(result *results) {
+            size_t n = 0;
+            const gfx::rect16 screen = display.bounds();
+
+            measure(results[n++], "clear", screen.width() * screen.height(),
+                [&](uint32_t i) {
+                    gfx::draw::filled_rectangle(display, screen,
+                        i & 1 ? gfx::color<pixel_type>::black
+                            : gfx::color<pixel_type>::white);
+                });
+
+            static const uint16_t fills[] = { 8, 32, 64 };
+            for(uint16_t size : fills) {
+                char name[sizeof(result::name)];
+                snprintf(name, sizeof(name), "fill %ux%u", size, size);
+                measure(results[n++], name, size * size, [&](uint32_t i) {
+                    gfx::draw::filled_rectangle(display,
+                        gfx::srect16(position(i, size), gfx::ssize16(size,
+                            size)),
+                        i & 1 ? gfx::color<pixel_type>::red
+                            : gfx::color<pixel_type>::blue);
+                });
+            }
+
+            n += blit(results + n, "blit 64 int", gfx::size16(64, 64),
+                MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            n += blit(results + n, "blit 64 psram", gfx::size16(64, 64),
+                MALLOC_CAP_SPIRAM);
+            n += blit(results + n, "blit full psram", screen.dimensions(),
+                MALLOC_CAP_SPIRAM);
+
+            const char *text = "Benchmark 0123";
+            gfx::srect16 textBounds = font.measure_text(
+                (gfx::ssize16)display.dimensions(), text).bounds();
+            measure(results[n++], "text", textBounds.width()
+                * textBounds.height(), [&](uint32_t i) {
+                    gfx::spoint16 p = position(i, textBounds.width());
+                    gfx::draw::text(display, textBounds.offset(p.x, p.y),
+                        text, font, i & 1 ? gfx::color<pixel_type>::white
+                            : gfx::color<pixel_type>::gray);
+                });
+            measure(results[n++], "text opaque", textBounds.width()
+                * textBounds.height(), [&](uint32_t i) {
+                    gfx::spoint16 p = position(i, textBounds.width());
+                    gfx::draw::text(display, textBounds.offset(p.x, p.y),
+                        text, font, i & 1 ? gfx::color<pixel_type>::white
+                            : gfx::color<pixel_type>::gray,
+                        gfx::color<pixel_type>::black, false);
+                });
+            n += glyphs(results + n, "text glyph cache", text, textBounds);
+
+            n += overlay(results + n, "blend frame int",
+                MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            n += overlay(results + n, "blend frame psram", MALLOC_CAP_SPIRAM);
+
+            n += frames<0>(results + n, "rotated");
+            n += frames<BENCHMARK_ROTATION>(results + n, "native");
+
+            if(jpegPath != nullptr && jpegPath[0] != '\0') {
+                n += image(results + n, "jpeg decode", jpegPath, false);
+                n += image(results + n, "jpeg draw", jpegPath, true);
+            }
+            if(q16Path != nullptr && q16Path[0] != '\0') {
+                n += image(results + n, "q16 decode", q16Path, false);
+                n += image(results + n, "q16 draw", q16Path, true);
+            }
+
+            gfx::draw::filled_rectangle(display, screen,
+                gfx::color<pixel_type>::black);
+            return n;
+        }
+
+    private:
+        Destination &display;
+        const gfx::font &font;
+        const char *jpegPath;
+        const char *q16Path;
+
+        // Opaque text from pre-expanded glyphs, comparable to "text opaque"
+        size_t glyphs(result *results, const char *name, const char *text,
+                const gfx::srect16 &textBounds) {
+            if constexpr(pixel_type::bit_depth != 16) {
+                return 0;
+            } else {
+                bcd_render::glyph_cache cache;
+                if(cache.initialize() != RENDER_OK) {
+                    return 0;
+                }
+                measure(results[0], name, textBounds.width()
+                    * textBounds.height(), [&](uint32_t i) {
+                        gfx::spoint16 p = position(i, textBounds.width());
+                        cache.draw(display, textBounds.offset(p.x, p.y),
+                            text, font, i & 1 ? gfx::color<pixel_type>::white
+                                : gfx::color<pixel_type>::gray,
+                            gfx::color<pixel_type>::black);
+                    });
+                return 1;
+            }
+        }
+
+        // A half transparent overlay over a whole frame in memory, the work
+        // of a dimmed background without sending it
+        size_t overlay(result *r, const char *name, uint32_t caps) {
+            if constexpr(pixel_type::bit_depth != 16) {
+                return 0;
+            } else {
+                const gfx::size16 size = display.dimensions();
+                uint8_t *buffer = (uint8_t *)heap_caps_malloc(
+                    bitmap_type::sizeof_buffer(size), caps);
+                if(buffer == nullptr) {
+                    ESP_LOGW(TAG_MOD_BENCHMARK, "Skipping %s: no memory.",
+                        name);
+                    return 0;
+                }
+                bitmap_type frame(size, buffer);
+                frame.clear(frame.bounds());
+                measure(*r, name, size.width * size.height, [&](uint32_t i) {
+                    bcd_render::blend(frame, (gfx::srect16)frame.bounds(),
+                        i & 1 ? gfx::color<pixel_type>::white
+                            : gfx::color<pixel_type>::blue, 128);
+                });
+                heap_caps_free(buffer);
+                return 1;
+            }
+        }
+
+        // Full screen and scattered cell updates through a display list. A
+        // list with a rotation of 0 leaves rotating to the driver.
+        template<uint8_t Rotation>
+        size_t frames(result *results, const char *order) {
+            using list_type = bcd_render::display_list<Destination, 16,
+                Rotation>;
+            if constexpr(pixel_type::bit_depth != 16) {
+                return 0;
+            } else {
+                void *memory = heap_caps_malloc(sizeof(list_type),
+                    MALLOC_CAP_8BIT);
+                if(memory == nullptr) {
+                    ESP_LOGW(TAG_MOD_BENCHMARK, "Skipping frames %s: no "
+                        "memory.", order);
+                    return 0;
+                }
+                list_type *list = new (memory) list_type(display);
+                size_t n = 0;
+                if(list->initialize() == RENDER_OK) {
+                    const gfx::rect16 screen = display.bounds();
+                    char name[sizeof(result::name)];
+                    snprintf(name, sizeof(name), "frame %s", order);
+                    measure(results[n++], name, screen.width()
+                        * screen.height(), [&](uint32_t i) {
+                            list->filled_rectangle(screen, i & 1
+                                ? gfx::color<pixel_type>::black
+                                : gfx::color<pixel_type>::white);
+                            list->flush();
+                        });
+                    // 16 playfield sized cells per frame
+                    snprintf(name, sizeof(name), "cells %s", order);
+                    measure(results[n++], name, 16 * 8 * 8, [&](uint32_t i) {
+                        for(uint32_t c = 0; c < 16; c++) {
+                            list->filled_rectangle(gfx::srect16(
+                                position(i * 16 + c, 8), gfx::ssize16(8, 8)),
+                                c & 1 ? gfx::color<pixel_type>::red
+                                    : gfx::color<pixel_type>::blue);
+                        }
+                        list->flush();
+                    });
+                } else {
+                    ESP_LOGW(TAG_MOD_BENCHMARK, "Skipping frames %s: no "
+                        "shadow framebuffer.", order);
+                }
+                list->~list_type();
+                heap_caps_free(memory);
+                return n;
+            }
+        }
+
+        // Walks the operations over the screen, so no case only measures
+        // one corner of the panel
+        gfx::spoint16 position(uint32_t i, uint16_t size) const {
+            uint16_t w = display.dimensions().width - size;
+            uint16_t h = display.dimensions().height - size;
+            return gfx::spoint16((i * 37) % (w + 1), (i * 23) % (h + 1));
+        }
+
+        template<typename Operation>
+        void measure(result &r, const char *name, uint32_t pixels,
+                Operation op) {
+            strncpy(r.name, name, sizeof(r.name) - 1);
+            r.name[sizeof(r.name) - 1] = '\0';
+            r.pixels = pixels;
+            r.ops = 0;
+            r.waitUs = -1;
+
+            const int64_t minUs = CONFIG_MOD_BENCHMARK_CASE_MS * 1000LL;
+            int64_t waitStart = waitUs();
+            int64_t total = 0;
+            int64_t start = esp_timer_get_time();
+            do {
+                op(r.ops++);
+                // Let the idle task feed the watchdog. The time spent
+                // sleeping is not counted.
+                if((r.ops & 0xff) == 0) {
+                    total += esp_timer_get_time() - start;
+                    vTaskDelay(1);
+                    start = esp_timer_get_time();
+                }
+            } while(total + esp_timer_get_time() - start < minUs);
+            if constexpr(bcd_render::is_esp_lcd<Destination>::value) {
+                display.wait_all_async();
+                r.waitUs = waitUs() - waitStart;
+            }
+            r.us = total + esp_timer_get_time() - start;
+        }
+
+        // Time the display driver spent blocked on the bus so far
+        int64_t waitUs() const {
+            if constexpr(bcd_render::is_esp_lcd<Destination>::value) {
+                return display.statistics().waitUs;
+            } else {
+                return -1;
+            }
+        }
+
+        size_t blit(result *r, const char *name, gfx::size16 size,
+                uint32_t caps) {
+            size_t bytes = bitmap_type::sizeof_buffer(size);
+            uint8_t *buffer = (uint8_t *)heap_caps_malloc(bytes, caps);
+            if(buffer == nullptr) {
+                ESP_LOGW(TAG_MOD_BENCHMARK, "Skipping %s: no memory.", name);
+                return 0;
+            }
+            bitmap_type bmp(size, buffer);
+            for(uint16_t y = 0; y < size.height; y++) {
+                gfx::draw::filled_rectangle(bmp, gfx::rect16(0, y,
+                    size.width - 1, y), y & 1 ? gfx::color<pixel_type>::green
+                        : gfx::color<pixel_type>::yellow);
+            }
+
+            bool full = size.width == display.dimensions().width;
+            measure(*r, name, size.width * size.height, [&](uint32_t i) {
+                gfx::draw::bitmap(display, gfx::srect16(full
+                    ? gfx::spoint16(0, 0) : position(i, size.width),
+                    (gfx::ssize16)size), bmp, bmp.bounds());
+            });
+            heap_caps_free(buffer);
+            return 1;
+        }
+
+        size_t image(result *r, const char *name, const char *path,
+                bool draw) {
+            struct state_t {
+                Destination *display;
+                bool draw;
+                uint32_t pixels;
+            } state = { &display, draw, 0 };
+
+            bool ok = true;
+            bool q16 = bcd_render::q16_image::matches(path);
+            measure(*r, name, 0, [&](uint32_t i) {
+                gfx::file_stream fs(path);
+                if(!fs.caps().read) {
+                    ok = false;
+                    return;
+                }
+                state.pixels = 0;
+                auto store = [](gfx::size16 dimensions,
+                        typename gfx::jpeg_image::region_type &region,
+                        gfx::point16 location, void *arg) {
+                    state_t *s = (state_t *)arg;
+                    s->pixels += region.dimensions().width
+                        * region.dimensions().height;
+                    if(!s->draw) {
+                        return gfx::gfx_result::success;
+                    }
+                    return gfx::draw::bitmap(*s->display,
+                        gfx::srect16((gfx::spoint16)location,
+                            (gfx::ssize16)region.dimensions()),
+                        region, region.bounds());
+                };
+                if(q16) {
+                    bcd_render::q16_image::load(&fs, store, &state);
+                } else {
+                    gfx::jpeg_image::load(&fs, store, &state);
+                }
+                fs.close();
+            });
+            if(!ok) {
+                ESP_LOGW(TAG_MOD_BENCHMARK, "Skipping %s: cannot open %s.",
+                    name, path);
+                return 0;
+            }
+            r->pixels = state.pixels;
+            return 1;
+        }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Menu and console entry points
+////////////////////////////////////////////////////////////////////////////////
+template<typename Destination>
+struct configuration {
+    static Destination *display;
+    static const gfx::font *font;
+    static const char *jpegPath;
+    static const char *q16Path;
+};
+
+template<typename Destination>
+Destination *configuration<Destination>::display = nullptr;
+template<typename Destination>
+const gfx::font *configuration<Destination>::font = nullptr;
+template<typename Destination>
+const char *configuration<Destination>::jpegPath = CONFIG_MOD_BENCHMARK_JPEG;
+template<typename Destination>
+const char *configuration<Destination>::q16Path = CONFIG_MOD_BENCHMARK_Q16;
+
+/**
+ * @brief Sets the display, font and images used by module_main() and
+ *      command()
+ */
+template<typename Destination>
+void configure(Destination &display, const gfx::font &font,
+        const char *jpegPath = CONFIG_MOD_BENCHMARK_JPEG,
+        const char *q16Path = CONFIG_MOD_BENCHMARK_Q16) {
+    configuration<Destination>::display = &display;
+    configuration<Destination>::font = &font;
+    configuration<Destination>::jpegPath = jpegPath;
+    configuration<Destination>::q16Path = q16Path;
+}
+
+template<typename Destination>
+benchmark_err_t runAndPrint(result *results, size_t *count) {
+    using cfg = configuration<Destination>;
+    if(cfg::display == nullptr || cfg::font == nullptr) {
+        ESP_LOGE(TAG_MOD_BENCHMARK, "Benchmark not configured.");
+        return BENCHMARK_ERR_NOT_CONFIGURED;
+    }
+    benchmark<Destination> b(*cfg::display, *cfg::font, cfg::jpegPath,
+        cfg::q16Path);
+    *count = b.run(results);
+    gfx::size16 d = cfg::display->dimensions();
+    print(results, *count, d.width * d.height);
+    return BENCHMARK_OK;
+}
+
+/**
+ * @brief Menu action. Runs the benchmark and shows the results.
+ *
+ * @param arg Unused, the display is set with configure()
+ */
+template<typename Destination>
+int module_main(void *arg) {
+    using cfg = configuration<Destination>;
+    result results[BENCHMARK_MAX_RESULTS];
+    size_t count;
+    benchmark_err_t err = runAndPrint<Destination>(results, &count);
+    if(err != BENCHMARK_OK) {
+        return err;
+    }
+
+    Destination &display = *cfg::display;
+    gfx::size16 d = display.dimensions();
+    int16_t lineHeight = cfg::font->height();
+    for(size_t i = 0; i < count; i++) {
+        char line[40];
+        format(results[i], d.width * d.height, line, sizeof(line));
+        gfx::draw::text(display, gfx::srect16(0, i * lineHeight, d.width - 1,
+            (i + 1) * lineHeight - 1), line, *cfg::font,
+            gfx::color<typename Destination::pixel_type>::white);
+    }
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_MOD_BENCHMARK_SHOW_MS));
+    return BENCHMARK_OK;
+}
+
+/**
+ * @brief Console command: benchmark
+ */
+template<typename Destination>
+int command(int argc, char **argv) {
+    result results[BENCHMARK_MAX_RESULTS];
+    size_t count;
+    return runAndPrint<Destination>(results, &count);
+}
+
+} // namespace bcd_benchmark
@@ -0,0 +1,35 @@
+#include "../include/mod_benchmark.hpp"
+
+namespace bcd_benchmark {
+
+// Pixels per second and the time a full screen of this operation takes
+static void rates(const result &r, uint32_t framePixels, double *pxPerS,
+        double *msPerFrame) {
+    *pxPerS = r.us > 0 ? (double)r.pixels * r.ops * 1e6 / r.us : 0;
+    *msPerFrame = *pxPerS > 0 ? framePixels * 1e3 / *pxPerS : 0;
+}
+
+void print(const result *results, size_t count, uint32_t framePixels) {
+    printf("%-18s %8s %10s %8s %10s %6s\n", "case", "ops", "ms/op", "Mpx/s",
+        "ms/frame", "cpu %");
+    for(size_t i = 0; i < count; i++) {
+        const result &r = results[i];
+        double pxPerS, msPerFrame;
+        rates(r, framePixels, &pxPerS, &msPerFrame);
+        printf("%-18s %8u %10.3f %8.2f %10.2f ", r.name, (unsigned)r.ops,
+            r.ops > 0 ? r.us / 1e3 / r.ops : 0, pxPerS / 1e6, msPerFrame);
+        if(r.waitUs >= 0 && r.us > 0) {
+            printf("%6.1f\n", 100.0 * (r.us - r.waitUs) / r.us);
+        } else {
+            printf("%6s\n", "-");
+        }
+    }
+}
+
+void format(const result &r, uint32_t framePixels, char *buf, size_t size) {
+    double pxPerS, msPerFrame;
+    rates(r, framePixels, &pxPerS, &msPerFrame);
+    snprintf(buf, size, "%-15s%5.1fms", r.name, msPerFrame);
+}
+
+} // namespace bcd_benchmark
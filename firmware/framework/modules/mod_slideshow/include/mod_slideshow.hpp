@@ -0,0 +1,125 @@
+/**
+ * @file    mod_slideshow.hpp
+ * @brief   Image slideshow with background decoding
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Shows a list of JPEG or q16 images one after the other, centred on the
+ * display. The images are decoded by a bcd_render::image_prefetcher: while
+ * one image is shown, the next is decoded on the other core into a back
+ * buffer in PSRAM. Moving on to the next image is then a single blit, and
+ * the decode work is spread over the time the previous image is shown
+ * instead of blocking the UI task when the image is due.
+ *
+ * Usage:
+ *      static const char *logos[] = { "/spiffs/logo_2k13.jpeg", ... };
+ *      bcd_slideshow::configure(logos, sizeof(logos) / sizeof(logos[0]));
+ *      mc.createActionItem("Logo Slideshow",
+ *          bcd_slideshow::module_main<lcd_type>, &lcd);
+ */
+#pragma once
+
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "esp_log.h"
+#include "gfx.hpp"
+#include "bcd_image_prefetcher.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Menuconfig options
+////////////////////////////////////////////////////////////////////////////////
+#define TAG_MOD_SLIDESHOW CONFIG_TAG_MOD_SLIDESHOW
+
+////////////////////////////////////////////////////////////////////////////////
+// Error handling
+////////////////////////////////////////////////////////////////////////////////
+typedef BaseType_t slideshow_err_t;
+
+#define SLIDESHOW_FAIL              -1                                          /**< Generic failure */
+#define SLIDESHOW_OK                0x000                                       /**< All good */
+#define SLIDESHOW_ERR_NOT_CONFIGURED 0x101                                      /**< configure() not called */
+#define SLIDESHOW_ERR_NO_MEM        0x102                                       /**< Could not start the prefetcher */
+
+namespace bcd_slideshow {
+
+/**
+ * @brief Sets the images shown by module_main()
+ *
+ * @param paths Paths of the images. The array is not copied and must stay
+ *      valid.
+ * @param count Number of paths
+ */
+void configure(const char *const *paths, size_t count);
+
+/**
+ * @brief Returns the configured images
+ */
+const char *const *images(size_t *count);
+
+/**
+ * @brief Menu action. Shows the configured images.
+ *
+ * @param arg Pointer to the display
+ */
+template<typename Destination>
+int module_main(void *arg) {
+    using pixel_type = typename Destination::pixel_type;
+    Destination &display = *(Destination *)arg;
+    size_t count;
+    const char *const *paths = images(&count);
+    if(paths == nullptr || count == 0) {
+        ESP_LOGE(TAG_MOD_SLIDESHOW, "Slideshow not configured.");
+        return SLIDESHOW_ERR_NOT_CONFIGURED;
+    }
+
+    bcd_render::image_prefetcher prefetcher;
+    if(prefetcher.initialize() != RENDER_OK) {
+        return SLIDESHOW_ERR_NO_MEM;
+    }
+    gfx::srect16 screen = (gfx::srect16)display.bounds();
+    gfx::draw::filled_rectangle(display, screen,
+        gfx::color<pixel_type>::black);
+
+    const size_t total = count * CONFIG_MOD_SLIDESHOW_ROUNDS;
+    gfx::size16 shown(0, 0);
+    TickType_t last = 0;
+    prefetcher.prefetch(paths[0]);
+    for(size_t i = 0; i < total; i++) {
+        const bcd_render::image_prefetcher::bitmap_type *image;
+        render_err_t err = prefetcher.take(&image);
+        // The next image decodes while this one is on the display
+        if(i + 1 < total) {
+            prefetcher.prefetch(paths[(i + 1) % count]);
+        }
+        if(err != RENDER_OK) {
+            ESP_LOGW(TAG_MOD_SLIDESHOW, "Skipping %s.", paths[i % count]);
+            continue;
+        }
+
+        if(shown.width != 0) {
+            vTaskDelayUntil(&last,
+                pdMS_TO_TICKS(CONFIG_MOD_SLIDESHOW_INTERVAL_MS));
+        } else {
+            last = xTaskGetTickCount();
+        }
+        gfx::size16 d = image->dimensions();
+        if(d.width != shown.width || d.height != shown.height) {
+            gfx::draw::filled_rectangle(display, screen,
+                gfx::color<pixel_type>::black);
+            shown = d;
+        }
+        gfx::draw::bitmap(display,
+            ((gfx::srect16)image->bounds()).center(screen), *image,
+            image->bounds());
+    }
+    if(shown.width != 0) {
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(CONFIG_MOD_SLIDESHOW_INTERVAL_MS));
+    }
+    return SLIDESHOW_OK;
+}
+
+} // namespace bcd_slideshow
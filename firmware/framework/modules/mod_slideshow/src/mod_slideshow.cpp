@@ -0,0 +1,18 @@
+#include "../include/mod_slideshow.hpp"
+
+namespace bcd_slideshow {
+
+static const char *const *imagePaths = nullptr;
+static size_t imageCount = 0;
+
+void configure(const char *const *paths, size_t count) {
+    imagePaths = paths;
+    imageCount = count;
+}
+
+const char *const *images(size_t *count) {
+    *count = imageCount;
+    return imagePaths;
+}
+
+} // namespace bcd_slideshow
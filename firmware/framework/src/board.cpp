@@ -12,6 +12,8 @@ namespace tetrics_module
 		score = 0;
 		currentRotation = 0;
 		inc = 0;
+		clearedRowCount = 0;
+		locks = 0;
 		
 		nextShapeColor = rand() % 6 + 1;
 		nextShapeIndex = rand() % 7;
@@ -37,6 +39,33 @@ namespace tetrics_module
 		
 		return true;
 	}
+	int board::fallProgress(TickType_t currTick, int steps)
+	{
+		TickType_t downDif = pdMS_TO_TICKS(downDifMS);
+
+		if (downDif == 0 || !canFall())
+			return 0;
+
+		TickType_t elapsed = currTick - lastTick;
+		if (elapsed >= downDif)
+			return steps - 1;
+
+		return elapsed * steps / downDif;
+	}
+	bool board::canFall()
+	{
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				if (currentShape[i][j] < 0)
+				{
+					int x = currentShapeX + i;
+					int y = currentShapeY + j + 1;
+					if (y >= height || board[x][y] > 0)
+						return false;
+				}
+
+		return true;
+	}
 	int board::getDropCoordinate()
 	{
 		for (int k = 0; k < height; ++k)
@@ -188,6 +217,7 @@ namespace tetrics_module
 			return true;
 
 		updateScore(4);
+		locks++;
 
 		for (int i = std::max(currentShapeX, 0); i < std::min(currentShapeX + 4, width); i++)
 			for (int j = std::max(currentShapeY, 0); j < std::min(currentShapeY + 4, height); j++)
@@ -206,6 +236,8 @@ namespace tetrics_module
 				if (numOfBlocks == width)
 				{
 					updateScore(10);
+					if (clearedRowCount < 4)
+						clearedRows[clearedRowCount++] = j;
 					for (int k = j; k > 0; k--)
 						for (int i = 0; i < width; i++)
 							board[i][k] = board[i][k - 1];
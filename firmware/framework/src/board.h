@@ -18,10 +18,16 @@ namespace tetrics_module
 
         int getDropCoordinate();
         void drop(TickType_t currTick);
+
+        // How far the current piece has fallen towards the next row, from 0
+        // right after a gravity step to steps - 1 just before the next one.
+        // Always 0 while the piece rests on the stack.
+        int fallProgress(TickType_t currTick, int steps);
+        bool canFall();
     
-        const int width = 10;
-        const int height = 22;
-        std::array<std::array<int, 22>, 10> board = {};        
+        static constexpr int width = 10;
+        static constexpr int height = 22;
+        std::array<std::array<int, height>, width> board = {};        
     private:
         using piece = std::array<std::array<int, 4>, 4>;
         int currentRotation; // has a value of 0, 1, 2 or 3 depending on the rotation of the figure
@@ -194,6 +200,15 @@ namespace tetrics_module
         int downDifMS;		
 		TickType_t lastTick = 0;        
         
+        // Rows removed by the last landed piece, in the order they were
+        // cleared. Consecutive full rows all show up with the same index, as
+        // the rows above move down into it. Reset by the renderer.
+        int clearedRows[4];
+        int clearedRowCount = 0;
+
+        // Number of pieces that landed since start()
+        int locks = 0;
+        
         bool createShape();
         bool checkCollision();
         piece getShape(int shapeIndex, int rotation);
@@ -1,4 +1,71 @@
 #include "main.hpp"
+#include <unistd.h>
+
+// Screens in the screen cache
+enum ScreenId : uint8_t
+{
+	SCREEN_START,
+	SCREEN_END,
+	SCREEN_BEHIND_BOX
+};
+
+// Shows the static part of a screen. It is composed once into the screen
+// cache and blitted from there with the next flush. If it cannot be cached,
+// it is drawn into the display list directly. compose(target, offset) draws
+// in screen coordinates moved by offset.
+template <typename Compose>
+void Main::showScreen(uint8_t id, const srect16 &bounds, Compose compose)
+{
+	auto composeCached = [&](bcd_render::screen_cache::bitmap_type &surface)
+	{
+		return compose(surface, spoint16(-bounds.left(), -bounds.top()));
+	};
+	auto composeDirect = [&](auto &target)
+	{
+		return compose(target, spoint16(0, 0));
+	};
+
+	const bcd_render::screen_cache::bitmap_type *screen;
+	if (screens.get(id, size16(bounds.width(), bounds.height()), composeCached, &screen) == RENDER_OK)
+		displayList.bitmap(bounds, *screen, screen->bounds());
+	else
+		displayList.compose(bounds, composeDirect);
+}
+
+void Main::prepareScreens()
+{
+	// All game screens draw through the display list. If there is not enough
+	// memory for its shadow framebuffer, it draws directly on the display.
+	displayList.initialize();
+	// Line clears use the panel's scroll registers where the rotation
+	// allows it
+	displayList.enable_hardware_scroll(LCD_HEIGHT);
+	// Text on solid backgrounds is copied from pre-expanded glyphs
+	if (glyphCache.initialize() == RENDER_OK)
+		displayList.use_glyph_cache(&glyphCache);
+	// The game screen places the board when it lays out the screen
+	playfield.initialize(spoint16(0, 0));
+	// Screens run one loop iteration per frame
+	frameClock.start();
+	// Effects die at the screen edges
+	particles.clip((srect16)lcd.bounds());
+	// Images compiled at build time are shown straight from flash
+	assets.initialize();
+	// The HUD font is rasterised once, so drawing it costs no more than
+	// the bitmap font. The font reads its outlines from the mapped asset.
+	bcd_assets::asset hudAsset;
+	if (assets.find(HUD_FONT_ASSET, &hudAsset) == ASSETS_OK && hudAsset.format == bcd_assets::format_e::RAW)
+	{
+		static const_buffer_stream hudStream(hudAsset.data, hudAsset.length);
+		if (open_font::open(&hudStream, &hudTypeface) == gfx_result::success)
+			hudFont.initialize(hudTypeface, HUD_FONT_SIZE);
+	}
+}
+
+const bcd_render::display_list_stats &Main::renderStatistics() const
+{
+	return displayList.allFlushes();
+}
 
 void Main::updateInput()
 {
@@ -39,12 +106,19 @@ Main::GameState Main::runStartScreen()
 	const char *exit_text = "Exit";
 	srect16 exit_text_rect = textFont.measure_text((ssize16)lcd.dimensions(), exit_text).bounds().center(start_text_rect).offset(0, start_text_rect.height() + 2);
 
-	lcd.clear(lcd.bounds());
-
-	draw::filled_rectangle(lcd, rect16(point16(45, 46), size16(70, 36)), color<pixel_type>::black);
-	draw::rectangle(lcd, rect16(point16(45, 46), size16(70, 36)), color<pixel_type>::white);
-	draw::text(lcd, start_text_rect, start_text, textFont, color<pixel_type>::white);
-	draw::text(lcd, exit_text_rect, exit_text, textFont, color<pixel_type>::white);
+	// The background image comes from the asset partition, the menu box on
+	// top of it from the screen cache
+	srect16 box_rect = srect16(spoint16(45, 46), ssize16(70, 36));
+	auto composeScreen = [&](auto &target, spoint16 o)
+	{
+		draw::filled_rectangle(target, box_rect.offset(o.x, o.y), color<pixel_type>::black);
+		draw::rectangle(target, box_rect.offset(o.x, o.y), color<pixel_type>::white);
+		draw::text(target, start_text_rect.offset(o.x, o.y), start_text, textFont, color<pixel_type>::white, color<pixel_type>::black, false);
+		return draw::text(target, exit_text_rect.offset(o.x, o.y), exit_text, textFont, color<pixel_type>::white, color<pixel_type>::black, false);
+	};
+	displayList.clear(lcd.bounds());
+	drawAsset("start_screen", point16(0, 0));
+	showScreen(SCREEN_START, box_rect, composeScreen);
 
 	int selectedButton = 0;
 	auto renderScene = [&]()
@@ -55,15 +129,16 @@ Main::GameState Main::runStartScreen()
 		{
 		case 0:
 		{
-			lcd.clear(exitDot);
-			draw::filled_ellipse(lcd, startDot, color<pixel_type>::white);
+			displayList.clear(exitDot);
+			displayList.filled_ellipse(startDot, color<pixel_type>::white);
 			break;
 		}
 		case 1:
-			lcd.clear(startDot);
-			draw::filled_ellipse(lcd, exitDot, color<pixel_type>::white);
+			displayList.clear(startDot);
+			displayList.filled_ellipse(exitDot, color<pixel_type>::white);
 			break;
 		}
+		displayList.flush();
 	};
 
 	renderScene();
@@ -105,7 +180,8 @@ Main::GameState Main::runStartScreen()
 		}
 	}
 
-	lcd.clear(lcd.bounds());
+	displayList.clear(lcd.bounds());
+	displayList.flush();
 
 	return exitState;
 }
@@ -134,47 +210,173 @@ pixel_type getColor(int value)
 	}
 }
 
+// Marks a cell that is covered by the ghost of the falling piece. The low
+// bits hold the colour of the piece.
+static const int CELL_GHOST = 0x10;
+// Marks a ghost cell drawn with its outline, which is left out when the
+// render quality goes down
+static const int CELL_OUTLINE = 0x20;
+static const int CELL_VALUE = 0x0f;
+
+// Playfield palette index of the translucent ghost fill of board value 1,
+// the other values follow. Indices 0 - 6 are the board values.
+static const uint8_t PLAYFIELD_GHOST = 7;
+
+// Opacity of the ghost fill, the dimmed screen behind dialogs and the dialog
+// boxes (0 - 255)
+static const uint8_t GHOST_ALPHA = 80;
+static const uint8_t DIM_ALPHA = 128;
+static const uint8_t BOX_ALPHA = 160;
+
+// Animation timing in microseconds
+static const uint32_t CLEAR_FLASH_US = 80000;
+static const uint32_t CLEAR_COLLAPSE_US = 60000;                               // Per cleared row
+static const uint32_t LOCK_PULSE_US = 200000;
+static const uint32_t PAUSE_OPEN_US = 150000;
+
+enum class ClearPhase
+{
+	None,
+	Flash,
+	Collapse
+};
+
+// Gray with the given level (0 - 255)
+static pixel_type grayLevel(int32_t level)
+{
+	pixel_type px;
+	px.native_value = ((level >> 3) << 11) | ((level >> 2) << 5) | (level >> 3);
+	return px;
+}
+
 Main::GameState Main::runGameScreen()
 {
 	const char *TETRIS_text = "TETRIS";
-	srect16 TETRIS_text_rect = textFont.measure_text((ssize16)lcd.dimensions(), TETRIS_text).bounds().center_horizontal((srect16)lcd.bounds());
+	srect16 TETRIS_text_rect = measureHudText(TETRIS_text).bounds().center_horizontal((srect16)lcd.bounds());
 	const char *score_text = "Score";
-	srect16 score_text_rect = textFont.measure_text((ssize16)lcd.dimensions(), score_text).bounds().offset(115, 10);
+	srect16 score_text_rect = measureHudText(score_text).bounds().offset(115, 10);
 	const char *Next_text = "Next";
-	srect16 Next_text_rect = textFont.measure_text((ssize16)lcd.dimensions(), Next_text).bounds().center(score_text_rect).offset(0, 20);
+	srect16 Next_text_rect = measureHudText(Next_text).bounds().center(score_text_rect).offset(0, 20);
 	const char* topScore_text = "Top";
-	srect16 topScore_text_rect = textFont.measure_text((ssize16)lcd.dimensions(), topScore_text).bounds().offset(15, 10);
+	srect16 topScore_text_rect = measureHudText(topScore_text).bounds().offset(15, 10);
 
-	srect16 GameRectangle_rect = srect16(spoint16(0, 0), ssize16(52, 112)).center_horizontal((srect16)lcd.bounds()).offset(0, 9);
-	srect16 NextRectangle_rect = srect16(spoint16(0, 0), ssize16(32, 32)).center_horizontal(Next_text_rect).offset(0, 9);
+	// The board with a one pixel border, the next piece with a margin of six
+	srect16 GameRectangle_rect = srect16(spoint16(0, 0), ssize16(playfield_type::width + 2, playfield_type::height + 2)).center_horizontal((srect16)lcd.bounds()).offset(0, 9);
+	srect16 NextRectangle_rect = srect16(spoint16(0, 0), ssize16(preview_type::width + 12, preview_type::height + 12)).center_horizontal(Next_text_rect).offset(0, 9);
+	playfield.place(spoint16(GameRectangle_rect.left() + 1, GameRectangle_rect.top() + 1));
+	preview.place(spoint16(NextRectangle_rect.left() + 6, NextRectangle_rect.top() + 6));
+	const int cellSize = playfield_type::cell_size;
 
-	draw::text(lcd, TETRIS_text_rect, TETRIS_text, textFont, color<pixel_type>::white);
-	draw::text(lcd, score_text_rect, score_text, textFont, color<pixel_type>::white);
-	draw::text(lcd, Next_text_rect, Next_text, textFont, color<pixel_type>::white);
-	draw::text(lcd, topScore_text_rect, topScore_text, textFont, color<pixel_type>::white);
+	drawHudText(TETRIS_text_rect, TETRIS_text, color<pixel_type>::white);
+	drawHudText(score_text_rect, score_text, color<pixel_type>::white);
+	drawHudText(Next_text_rect, Next_text, color<pixel_type>::white);
+	drawHudText(topScore_text_rect, topScore_text, color<pixel_type>::white);
 
 	for (int i = 0; i < previousScoreCount; ++i)
 	{
 		char text[128];
 		sprintf(text, "%d", previousScores[i]);
-		srect16 rect = textFont.measure_text((ssize16)lcd.dimensions(), text).bounds().center(topScore_text_rect).offset(0, 10 + 10 * i);
+		srect16 rect = measureHudText(text).bounds().center(topScore_text_rect).offset(0, 10 + 10 * i);
 
-		draw::text(lcd, rect, text, textFont, color<pixel_type>::gray);
+		drawHudText(rect, text, color<pixel_type>::gray);
 	}
 	
-	draw::rectangle(lcd, GameRectangle_rect, color<pixel_type>::white);
-	draw::rectangle(lcd, NextRectangle_rect, color<pixel_type>::white);
+	displayList.rectangle(GameRectangle_rect, color<pixel_type>::white);
+	displayList.rectangle(NextRectangle_rect, color<pixel_type>::white);
 	
 	if (!paused)
 		board.start();
 	paused = false;
 
-	uint8_t* gameBmpBuffer = (uint8_t *)malloc(bmp_type::sizeof_buffer(size16(board.width * 10, board.height * 22))*sizeof(uint8_t));
-	bmp_type gameBmp { size16(board.width * 10, board.height * 22), gameBmpBuffer };
+	for (int i = 0; i <= 6; ++i)
+		playfield.color(i, getColor(i));
+	for (int i = 1; i <= 6; ++i)
+	{
+		pixel_type ghost;
+		ghost.native_value = bcd_render::rgb565::mix(getColor(i).native_value, getColor(0).native_value, GHOST_ALPHA);
+		playfield.color(PLAYFIELD_GHOST + i - 1, ghost);
+	}
+
+	// The playfield only shows the piece colours, so it goes to the panel
+	// in 12 bit. The pause and end screens blend over it and need 16 bit.
+	displayList.enable_rgb444(GameRectangle_rect);
 
 	int displayerScore = -1;
+	int shownNextIndex = -1;
+	int shownNextColor = -1;
+	int shownCells[playfield_type::columns][playfield_type::rows];
+	memset(shownCells, -1, sizeof(shownCells));
+
+	// Animation state. The tweens write into these locals, so the timeline
+	// is cleared before any of them can go out of scope.
+	timeline.clear();
+	ClearPhase clearPhase = ClearPhase::None;
+	bcd_render::tween_handle clearTween = RENDER_NO_TWEEN;
+	int32_t clearValue = 0;
+	int collapseRows = 0;
+	int collapseBottom = 0;
+	int collapseApplied = 0;
+	rect16 collapseArea;
+	bcd_render::tween_handle borderTween = RENDER_NO_TWEEN;
+	int32_t borderLevel = 255;
+	int32_t shownBorderLevel = 255;
+	int shownLocks = board.locks;
+
+	// The falling piece is not part of the playfield surface. It is drawn on
+	// top of it as a sprite that slides down between gravity steps. Moving it
+	// repaints the cells under its old position and the piece at the new one,
+	// so only these two areas are sent.
+	bool pieceShown = false;
+	int shownPieceX = 0;
+	int shownPieceTop = 0;
+	int shownPieceColor = 0;
+	auto shownPiece = board.currentShape;
+	rect16 shownPieceRect;
+
+	// Playfield area covered by the cells of the current piece, with its top
+	// row at top pixels
+	auto pieceRect = [&](int top)
+	{
+		int left = 4, right = -1, upper = 4, lower = -1;
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				if (board.currentShape[i][j] < 0)
+				{
+					left = std::min(left, i);
+					right = std::max(right, i);
+					upper = std::min(upper, j);
+					lower = std::max(lower, j);
+				}
+
+		return rect16(point16(playfield_type::pixels(board.currentShapeX + left), top + playfield_type::pixels(upper)), size16(playfield_type::pixels(right - left + 1), playfield_type::pixels(lower - upper + 1)));
+	};
+
+	// Makes the cell diff repaint the cells the piece was shown over
+	auto hidePiece = [&]()
+	{
+		if (!pieceShown)
+			return;
+		for (int i = shownPieceRect.left() / cellSize; i <= shownPieceRect.right() / cellSize; ++i)
+			for (int j = shownPieceRect.top() / cellSize; j <= shownPieceRect.bottom() / cellSize; ++j)
+				if (i >= 0 && i < board.width && j >= 0 && j < board.height)
+					shownCells[i][j] = -1;
+		pieceShown = false;
+	};
+
+	// Particles are erased before anything else of a frame is drawn and
+	// drawn after everything else, so they never end up in what they restore
+	particles.clear();
+
+	// Effects and decorations are cut back while frames take too long
+	quality.reset();
+
 	while (true)
 	{
+		int64_t now = frameClock.wait();
+		quality.update(frameClock);
+		timeline.update(now);
+		particles.erase(displayList);
+		particles.update(now);
 		updateInput();		
 		TickType_t tick = xTaskGetTickCount();
 
@@ -201,11 +403,16 @@ Main::GameState Main::runGameScreen()
 		if (pauseButtonPressed)
 		{
 			paused = true;
+			displayList.disable_rgb444();
 			return GameState::Paused;
 		}
 		if (upButtonPressed)
 		{
 			board.drop(tick);
+
+			// Dust where the piece lands
+			srect16 landed = playfield.screen(pieceRect(playfield_type::pixels(board.currentShapeY)));
+			particles.emit(srect16(spoint16(landed.left(), landed.bottom() - 1), ssize16(landed.width(), 2)), quality.effects(12), color<pixel_type>::gray, 96, 160, 20);
 		}
 
 
@@ -213,6 +420,9 @@ Main::GameState Main::runGameScreen()
 
 		if (!board.frame(tick))
 		{
+			const bcd_render::quality_stats &q = quality.statistics();
+			ESP_LOGI(TAG_STATE, "Game over after %u frames: load %u%% (peak %u%%), %u overruns, %u frames at reduced quality", (unsigned)q.frames, q.load, q.peak, (unsigned)q.overruns, (unsigned)q.reduced);
+			displayList.disable_rgb444();
 			return GameState::Lost;
 		}
 
@@ -220,42 +430,195 @@ Main::GameState Main::runGameScreen()
 		{
 		char score_number[128];
 		sprintf(score_number, "%d", board.score);
-		srect16 score_number_rect = textFont.measure_text((ssize16)lcd.dimensions(), score_number).bounds().center((srect16)score_text_rect).offset(0, 10);
-		draw::filled_rectangle(lcd, score_number_rect, color<pixel_type>::black);
-		draw::text(lcd, score_number_rect, score_number, textFont, color<pixel_type>::gray);
+		srect16 score_number_rect = measureHudText(score_number).bounds().center((srect16)score_text_rect).offset(0, 10);
+		displayList.filled_rectangle(score_number_rect, color<pixel_type>::black);
+		drawHudText(score_number_rect, score_number, color<pixel_type>::gray);
 
 		displayerScore = board.score;
 		}
 
-		for (int i = 0; i < 4; ++i)
-			for (int j = 0; j < 4; ++j)
+		if (shownNextIndex != board.nextShapeIndex || shownNextColor != board.nextShapeColor)
+		{
+			for (int i = 0; i < 4; ++i)
+				for (int j = 0; j < 4; ++j)
+				{
+					pixel_type rectColor = getColor(abs(board.nextShape[i][j] * board.nextShapeColor));
+					displayList.filled_rectangle(preview.screen(i, j), rectColor);
+				}
+
+			shownNextIndex = board.nextShapeIndex;
+			shownNextColor = board.nextShapeColor;
+		}
+
+		// A new clear while the last one is still animating: jump to the
+		// end and repaint the playfield from the board.
+		if (board.clearedRowCount > 0 && clearPhase != ClearPhase::None)
+		{
+			timeline.cancel(clearTween);
+			clearPhase = ClearPhase::None;
+			memset(shownCells, -1, sizeof(shownCells));
+		}
+
+		// Full rows flash and then collapse by scrolling the rows above them
+		// down, instead of redrawing the whole stack. Only a single block of
+		// rows can be collapsed this way, other cases are left to the redraw
+		// below.
+		if (board.clearedRowCount > 0)
+		{
+			hidePiece();
+
+			// Sparks out of every cleared row. Rows are recorded bottom up
+			// after the earlier clears moved the stack down, so the k-th
+			// one is shown k rows further up.
+			for (int k = 0; k < board.clearedRowCount; ++k)
 			{
-				pixel_type rectColor = getColor(abs(board.nextShape[i][j] * board.nextShapeColor));
-				rect16 rectangle(point16(NextRectangle_rect.x1 + 6 + i * 5, NextRectangle_rect.y1 + 6 + j * 5), size16(5, 5));
-				draw::filled_rectangle(lcd, rectangle, rectColor);
+				int row = board.clearedRows[k] - k;
+				particles.emit(playfield.screen(playfield_type::cells(0, row, board.width, 1)), quality.effects(24), color<pixel_type>::white, 128, 256, 45);
 			}
-		
-		for (int i = 0; i < board.width; ++i)
+
+			bool contiguous = true;
+			for (int k = 1; k < board.clearedRowCount; ++k)
+				if (board.clearedRows[k] != board.clearedRows[0])
+					contiguous = false;
+
+			if (contiguous)
+			{
+				collapseRows = board.clearedRowCount;
+				collapseBottom = board.clearedRows[0];
+				collapseArea = (rect16)playfield.screen(playfield_type::cells(0, 0, board.width, collapseBottom + 1));
+
+				displayList.filled_rectangle(playfield.screen(playfield_type::cells(0, collapseBottom - collapseRows + 1, board.width, collapseRows)), color<pixel_type>::white);
+				clearTween = timeline.start(&clearValue, 0, 1, CLEAR_FLASH_US);
+				clearPhase = ClearPhase::Flash;
+			}
+			board.clearedRowCount = 0;
+		}
+
+		if (clearPhase == ClearPhase::Flash && !timeline.active(clearTween))
 		{
-			for (int j = 0; j < board.height; ++j)
-			{				
-				pixel_type rectColor = getColor(abs(board.board[i][j]));
-				rect16 rectangle(point16(i * 5, j * 5), size16(5, 5));
-				draw::filled_rectangle(gameBmp, rectangle, rectColor);
+			displayList.filled_rectangle(playfield.screen(playfield_type::cells(0, collapseBottom - collapseRows + 1, board.width, collapseRows)), color<pixel_type>::black);
+			for (int i = 0; i < board.width; ++i)
+				for (int j = collapseBottom - collapseRows + 1; j <= collapseBottom; ++j)
+					shownCells[i][j] = 0;
+
+			collapseApplied = 0;
+			clearValue = 0;
+			clearTween = timeline.start(&clearValue, 0, playfield_type::pixels(collapseRows), CLEAR_COLLAPSE_US * collapseRows, bcd_render::ease::OUT);
+			clearPhase = ClearPhase::Collapse;
+		}
+
+		if (clearPhase == ClearPhase::Collapse)
+		{
+			if (clearValue > collapseApplied)
+			{
+				displayList.scroll(collapseArea, clearValue - collapseApplied);
+				collapseApplied = clearValue;
+			}
+
+			if (!timeline.active(clearTween))
+			{
+				// The blank rows wrapped around to the top
+				for (int i = 0; i < board.width; ++i)
+				{
+					for (int j = collapseBottom; j >= collapseRows; --j)
+						shownCells[i][j] = shownCells[i][j - collapseRows];
+					for (int j = 0; j < collapseRows; ++j)
+						shownCells[i][j] = 0;
+				}
+				clearPhase = ClearPhase::None;
 			}
 		}
 
-		for (int i = 0; i < 4; ++i)
-			for (int j = 0; j < 4; ++j)
-				if (board.currentShape[i][j] < 0)
+		// The playfield border pulses when a piece lands
+		if (board.locks != shownLocks)
+		{
+			timeline.cancel(borderTween);
+			borderTween = timeline.start(&borderLevel, 255, 96, LOCK_PULSE_US, bcd_render::ease::PULSE);
+			shownLocks = board.locks;
+		}
+		if (borderLevel != shownBorderLevel)
+		{
+			displayList.rectangle(GameRectangle_rect, grayLevel(borderLevel));
+			shownBorderLevel = borderLevel;
+		}
+
+		// Cells are only redrawn while no clear animation owns the playfield
+		if (clearPhase != ClearPhase::None)
+		{
+			particles.draw(displayList);
+			displayList.flush();
+			continue;
+		}
+
+		// The piece slides down one pixel at a time, cellSize steps per
+		// gravity interval
+		int pieceTop = playfield_type::pixels(board.currentShapeY) + board.fallProgress(tick, cellSize);
+		bool pieceMoved = !pieceShown || pieceTop != shownPieceTop || board.currentShapeX != shownPieceX || board.currentShapeColor != shownPieceColor || board.currentShape != shownPiece;
+		rect16 newPieceRect = pieceRect(pieceTop);
+		if (pieceMoved)
+			hidePiece();
+
+		// Only cells that look different from what is on the display are
+		// redrawn. The ghost is part of a cell's look, the falling piece is
+		// not.
+		int dropY = board.getDropCoordinate();
+		for (int i = 0; i < board.width; ++i)
+		{
+			for (int j = 0; j < board.height; ++j)
+			{
+				int cell = std::max(board.board[i][j], 0);
+				int ghostI = i - board.currentShapeX;
+				int ghostJ = j - dropY;
+				if (ghostI >= 0 && ghostI < 4 && ghostJ >= 0 && ghostJ < 4 && board.currentShape[ghostI][ghostJ] < 0)
+					cell = CELL_GHOST | (quality.outlines() ? CELL_OUTLINE : 0) | board.currentShapeColor;
+
+				if (cell == shownCells[i][j])
+					continue;
+				shownCells[i][j] = cell;
+
+				if (cell & CELL_OUTLINE)
+				{
+					// A translucent cell with a solid outline
+					playfield.outlined(i, j, PLAYFIELD_GHOST + (cell & CELL_VALUE) - 1, cell & CELL_VALUE);
+				}
+				else if (cell & CELL_GHOST)
 				{
-					rect16 rectangle(point16(board.currentShapeX * 5 + i * 5, board.getDropCoordinate() * 5 + j * 5), size16(5, 5));
-					draw::rectangle(gameBmp, rectangle, color<pixel_type>::white);
+					playfield.set(i, j, PLAYFIELD_GHOST + (cell & CELL_VALUE) - 1);
 				}
+				else
+				{
+					playfield.set(i, j, cell);
+				}
+
+				playfield.draw(displayList, i, j);
+
+				// A repainted cell under the piece covers part of it
+				if (playfield_type::cell(i, j).intersects(newPieceRect))
+					pieceMoved = true;
+			}
+		}
+
+		if (pieceMoved)
+		{
+			pixel_type pieceColor = getColor(board.currentShapeColor);
+			for (int i = 0; i < 4; ++i)
+				for (int j = 0; j < 4; ++j)
+					if (board.currentShape[i][j] < 0)
+						playfield.sprite(displayList, board.currentShapeX + i, pieceTop + playfield_type::pixels(j), pieceColor);
+
+			pieceShown = true;
+			shownPieceX = board.currentShapeX;
+			shownPieceTop = pieceTop;
+			shownPieceColor = board.currentShapeColor;
+			shownPiece = board.currentShape;
+			shownPieceRect = newPieceRect;
+		}
 
-		draw::bitmap(lcd, rect16(point16(55, 10), size16(50, 110)), gameBmp, rect16(point16(0, 0), size16(50, 110)));
+		particles.draw(displayList);
+		displayList.flush();
 	}
 
+	displayList.disable_rgb444();
 	return GameState::Start;
 }
 
@@ -267,13 +630,52 @@ Main::GameState Main::runPauseScreen()
 	srect16 text2_rect = textFont.measure_text((ssize16)lcd.dimensions(), text2).bounds().center((srect16)lcd.bounds().offset(0, +5));
 	srect16 textRectangle_rect = srect16(spoint16(0, 0), ssize16(text2_rect.width() + 2, 34)).center((srect16)lcd.bounds());
 
-	draw::filled_rectangle(lcd, textRectangle_rect, color<pixel_type>::black);
-	draw::rectangle(lcd, textRectangle_rect, color<pixel_type>::white);
-	draw::text(lcd, text1_rect, text1, textFont, color<pixel_type>::white);
-	draw::text(lcd, text2_rect, text2, textFont, color<pixel_type>::white);	
+	// The game stays visible behind the box, dimmed. Without a shadow
+	// framebuffer blending is an opaque fill, so nothing is dimmed.
+	if (displayList.buffered())
+		displayList.blend(lcd.bounds(), color<pixel_type>::black, DIM_ALPHA);
+	displayList.flush();
+
+	// Every step of the opening box is drawn over a copy of what was behind
+	// it, so the translucent fill does not add up from frame to frame. If
+	// there is no copy, the box is opaque.
+	auto copyBehind = [&](bcd_render::screen_cache::bitmap_type &surface)
+	{
+		return bcd_render::blit(surface, (srect16)surface.bounds(), *displayList.surface(), (rect16)textRectangle_rect);
+	};
+	const bcd_render::screen_cache::bitmap_type *behind = nullptr;
+	screens.invalidate(SCREEN_BEHIND_BOX);
+	if (!displayList.buffered() || screens.get(SCREEN_BEHIND_BOX, size16(textRectangle_rect.width(), textRectangle_rect.height()), copyBehind, &behind) != RENDER_OK)
+		behind = nullptr;
+	uint8_t boxAlpha = behind != nullptr ? BOX_ALPHA : 255;
+
+	// The box opens from its middle line, the text appears once it is open
+	timeline.clear();
+	int32_t boxHeight = 2;
+	int32_t shownBoxHeight = 0;
+	bcd_render::tween_handle openTween = timeline.start(&boxHeight, 2, textRectangle_rect.height(), PAUSE_OPEN_US, bcd_render::ease::OUT);
+	bool textShown = false;
 
 	while (true)
 	{
+		timeline.update(frameClock.wait());
+		if (boxHeight != shownBoxHeight)
+		{
+			srect16 box = srect16(spoint16(0, 0), ssize16(textRectangle_rect.width(), boxHeight)).center(textRectangle_rect);
+			if (behind != nullptr)
+				displayList.bitmap(textRectangle_rect, *behind, behind->bounds());
+			displayList.blend(box, color<pixel_type>::black, boxAlpha);
+			displayList.rectangle(box, color<pixel_type>::white);
+			shownBoxHeight = boxHeight;
+		}
+		if (!textShown && !timeline.active(openTween))
+		{
+			displayList.text(text1_rect, text1, textFont, color<pixel_type>::white);
+			displayList.text(text2_rect, text2, textFont, color<pixel_type>::white);
+			textShown = true;
+		}
+		displayList.flush();
+
 		updateInput();
 
 		if (upButtonPressed ||
@@ -286,7 +688,8 @@ Main::GameState Main::runPauseScreen()
 			break;
 	}
 
-	lcd.clear(lcd.bounds());
+	displayList.clear(lcd.bounds());
+	displayList.flush();
 
 	return GameState::Running;
 }
@@ -300,10 +703,13 @@ Main::GameState Main::runLostScreen()
 	srect16 text2_rect = textFont.measure_text((ssize16)lcd.dimensions(), text2).bounds().center((srect16)lcd.bounds().offset(0, +5));
 	srect16 textRectangle_rect = srect16(spoint16(0, 0), ssize16(text2_rect.width() + 2, 34)).center((srect16)lcd.bounds());
 
-	draw::filled_rectangle(lcd, textRectangle_rect, color<pixel_type>::black);
-	draw::rectangle(lcd, textRectangle_rect, color<pixel_type>::white);
-	draw::text(lcd, text1_rect, text1, textFont, color<pixel_type>::white);
-	draw::text(lcd, text2_rect, text2, textFont, color<pixel_type>::white);
+	// A translucent box over the dimmed last frame of the game
+	if (displayList.buffered())
+		displayList.blend(lcd.bounds(), color<pixel_type>::black, DIM_ALPHA);
+	displayList.blend(textRectangle_rect, color<pixel_type>::black, BOX_ALPHA);
+	displayList.rectangle(textRectangle_rect, color<pixel_type>::white);
+	displayList.text(text1_rect, text1, textFont, color<pixel_type>::white);
+	displayList.text(text2_rect, text2, textFont, color<pixel_type>::white);
 
 	for (int i = 0; i < 9; ++i)
 		previousScores[i + 1] = previousScores[i];
@@ -313,6 +719,8 @@ Main::GameState Main::runLostScreen()
 
 	previousScores[0] = board.score;
 
+	displayList.flush();
+
 	while (true)
 	{
 		updateInput();
@@ -327,7 +735,8 @@ Main::GameState Main::runLostScreen()
 			break;
 	}
 
-	lcd.clear(lcd.bounds());
+	displayList.clear(lcd.bounds());
+	displayList.flush();
 
 	return GameState::Start;
 }
@@ -341,13 +750,18 @@ Main::GameState Main::runEndScreen()
 	const char *exit_text = "Exit\r\n";
 	srect16 exit_text_rect = textFont.measure_text((ssize16)lcd.dimensions(), exit_text).bounds().center(play_again_text_rect).offset(0, 12);
 
-	draw::filled_ellipse(lcd, rect16(point16(10, 10), lcd.dimensions().inflate(-20, -20)), color<pixel_type>::red);
-	// drawJPEG("/a.jpeg", point16(0, 0));
-
-	draw::filled_rectangle(lcd, rect16(point16(45, 46), size16(70, 36)), color<pixel_type>::black);
-	draw::rectangle(lcd, rect16(point16(45, 46), size16(70, 36)), color<pixel_type>::white);
-	draw::text(lcd, play_again_text_rect, play_again_text, textFont, color<pixel_type>::white);
-	draw::text(lcd, exit_text_rect, exit_text, textFont, color<pixel_type>::white);
+	// Like the start screen, the menu box over the background image
+	srect16 box_rect = srect16(spoint16(45, 46), ssize16(70, 36));
+	auto composeScreen = [&](auto &target, spoint16 o)
+	{
+		draw::filled_rectangle(target, box_rect.offset(o.x, o.y), color<pixel_type>::black);
+		draw::rectangle(target, box_rect.offset(o.x, o.y), color<pixel_type>::white);
+		draw::text(target, play_again_text_rect.offset(o.x, o.y), play_again_text, textFont, color<pixel_type>::white, color<pixel_type>::black, false);
+		return draw::text(target, exit_text_rect.offset(o.x, o.y), exit_text, textFont, color<pixel_type>::white, color<pixel_type>::black, false);
+	};
+	displayList.clear(lcd.bounds());
+	drawAsset("end_screen", point16(0, 0));
+	showScreen(SCREEN_END, box_rect, composeScreen);
 
 	int selectedButton = 0;
 	auto renderScene = [&]()
@@ -358,15 +772,16 @@ Main::GameState Main::runEndScreen()
 		{
 		case 0:
 		{
-			lcd.clear(exitDot);
-			draw::filled_ellipse(lcd, startDot, color<pixel_type>::white);
+			displayList.clear(exitDot);
+			displayList.filled_ellipse(startDot, color<pixel_type>::white);
 			break;
 		}
 		case 1:
-			lcd.clear(startDot);
-			draw::filled_ellipse(lcd, exitDot, color<pixel_type>::white);
+			displayList.clear(startDot);
+			displayList.filled_ellipse(exitDot, color<pixel_type>::white);
 			break;
 		}
+		displayList.flush();
 	};
 
 	renderScene();
@@ -407,31 +822,82 @@ Main::GameState Main::runEndScreen()
 		}
 	}
 
-	lcd.clear(lcd.bounds());
+	displayList.clear(lcd.bounds());
+	displayList.flush();
 
 	return exitState;
 }
 
-point16 _drawJPEG_destination;
+void Main::drawAsset(const char *name, point16 destination)
+{
+	// Uncompressed assets are blitted from the mapped partition with the next
+	// flush, no file system and no decoding involved
+	bcd_assets::asset a;
+	if (assets.find(name, &a) == ASSETS_OK && a.format == bcd_assets::format_e::RGB565)
+	{
+		displayList.bitmap(rect16(destination, a.dimensions), a.bitmap(), rect16(point16(0, 0), a.dimensions));
+		return;
+	}
+
+	// Not flashed, fall back to the image on SPIFFS. The lossless q16 version
+	// decodes faster than the JPEG, so it is preferred if there is one.
+	char path[48];
+	snprintf(path, sizeof(path), "/spiffs/%s.q16", name);
+	if (access(path, F_OK) != 0)
+	{
+		snprintf(path, sizeof(path), "/spiffs/%s.jpeg", name);
+	}
+	drawJPEG(path, destination);
+}
+
+ssize16 Main::measureHudText(const char *text)
+{
+	if (hudFont.initialized())
+	{
+		return hudFont.measure_text((ssize16)lcd.dimensions(), text);
+	}
+	return textFont.measure_text((ssize16)lcd.dimensions(), text);
+}
+
+void Main::drawHudText(const srect16 &rect, const char *text, pixel_type tint)
+{
+	// Anti-aliased glyphs are blended over the black background, bitmap
+	// glyphs are copied with it from the glyph cache
+	if (hudFont.initialized())
+	{
+		displayList.text(rect, text, hudFont, tint);
+		return;
+	}
+	displayList.text(rect, text, textFont, tint, color<pixel_type>::black);
+}
 
 void Main::drawJPEG(const char *path, point16 destination)
 {
-	_drawJPEG_destination = destination;
-	file_stream fs(path);
-	if (!fs.caps().read)
+	// Images shown before are blitted from the cache with the next flush.
+	// Only if the image cannot be cached it is streamed from the file system.
+	const bcd_render::image_cache::bitmap_type *image;
+	if (imageCache.get(path, &image) == RENDER_OK)
 	{
-		ESP_LOGE(TAG_FS, "Failed to open a.jpeg");
+		displayList.bitmap(rect16(destination, image->dimensions()), *image, image->bounds());
+		return;
 	}
-	else
+
+	// Without a shadow framebuffer the image is streamed to the display,
+	// after anything recorded so far
+	if (!displayList.buffered())
 	{
-		jpeg_image::load(
-			&fs,
-			[](size16 dimensions, jpeg_image::region_type &region, point16 location, void *state)
-			{
-				_drawJPEG_destination.x += location.x;
-				_drawJPEG_destination.y += location.y;
-				return draw::bitmap(bcd_sys.getDisplay(), rect16(_drawJPEG_destination, region.dimensions()), region, region.bounds());
-			},
-			nullptr);
+		displayList.flush();
+		jpegRenderer.draw(path, (spoint16)destination);
+		return;
 	}
+
+	// Otherwise it is decoded into the shadow framebuffer, so later flushes,
+	// blends and captures see it. Its size is only known once it is
+	// decoded, so the rest of the screen is marked.
+	srect16 area(destination.x, destination.y, lcd.dimensions().width - 1, lcd.dimensions().height - 1);
+	displayList.compose(area, [&](auto &target)
+	{
+		bcd_render::jpeg_renderer<std::remove_reference_t<decltype(target)>> renderer(target);
+		return renderer.draw(path, (spoint16)destination) == RENDER_OK ? gfx_result::success : gfx_result::invalid_format;
+	});
 }
\ No newline at end of file
@@ -27,6 +27,7 @@ void Main::run(void) {
 	// etc... this is a good place to set them up.
 	
 	// <--- Set up objects etc... used throughout firmware below -->
+	bcd_benchmark::configure(lcd, textFont);
 
 	// <--- Set up objects etc... used throughout firmware above -->
 
@@ -42,6 +43,12 @@ void Main::run(void) {
 	if(bcd_sys.consoleSupport()) {
 		// <--- Register console commands below -->
 		// Make sure to also include needed headers in main.hpp
+		console.registerCommand("screenshot", &screenshot,
+			"Send the framebuffer as binary frame. Decode with "
+			"tools/screenshot.py.");
+		console.registerCommand("benchmark", &bcd_benchmark::command<lcd_type>,
+			"Measure fill, blit, text and JPEG throughput of the display. "
+			"Draws over the screen.");
 
 		// <--- Register console commands above -->
 	}
@@ -67,6 +74,22 @@ void Main::run(void) {
 	
 	// <--- Put setup code and one time acitons below -->	
 
+#if CONFIG_GAME_RANDOM_SEED == 0
+	srand(esp_random());
+#else
+	srand(CONFIG_GAME_RANDOM_SEED);
+#endif
+
+	// The display list, caches and fonts of the game screens
+	prepareScreens();
+	if(displayList.buffered()) {
+		// The shadow framebuffer is in the panel's native orientation,
+		// captures are turned back into screen orientation
+		screenshot_set_source(displayList.framebuffer()->begin(),
+			displayList.framebuffer()->dimensions().width,
+			displayList.framebuffer()->dimensions().height, LCD_ROTATION);
+	}
+
 	
 	//screenSize = lcd.dimensions();
     //screenBuffer = (uint8_t *)malloc(bmp_type::sizeof_buffer(screenSize)*sizeof(uint8_t));
@@ -25,8 +25,21 @@
  */
 #include "bcd_system.hpp"
 #include "ch405labs_esp_debug.h"
+#include "esp_random.h"
 #ifdef CONFIG_DISPLAY_SUPPORT
 #include "ch405labs_gfx_menu.hpp"
+#include "bcd_display_list.hpp"
+#include "bcd_frame_clock.hpp"
+#include "bcd_timeline.hpp"
+#include "bcd_image_cache.hpp"
+#include "bcd_jpeg_renderer.hpp"
+#include "bcd_glyph_cache.hpp"
+#include "bcd_glyph_atlas.hpp"
+#include "bcd_screen_cache.hpp"
+#include "bcd_particles.hpp"
+#include "bcd_playfield.hpp"
+#include "bcd_quality.hpp"
+#include "bcd_assets.hpp"
 #endif // CONFIG_DISPLAY_SUPPORT
 
 
@@ -38,11 +51,13 @@
 //
 // Add includes for the modules you use here
 #include "mod_template.hpp"
+#include "mod_benchmark.hpp"
 
 // <----------------------------- Commands ------------------------------------>
 //
 // Add commands for the modules you use here
 #include "cmd_template.hpp"
+#include "cmd_screenshot.hpp"
 
 
 // Namespaces
@@ -67,6 +82,19 @@ using const_bmp_type = const_bitmap<rgb_pixel<16>>;
 using mask_type = const_bitmap<gsc_pixel<1>>;
 using sprite_type = sprite<rgb_pixel<16>>;
 
+// Board cells are squares of PLAYFIELD_CELL_SIZE pixels. The layout of the
+// game screen follows from it.
+#define PLAYFIELD_CELL_SIZE 5
+using playfield_type = bcd_render::playfield_renderer<pixel_type,
+    PLAYFIELD_CELL_SIZE, tetrics_module::board::width,
+    tetrics_module::board::height>;
+using preview_type = bcd_render::tile_grid<PLAYFIELD_CELL_SIZE, 4, 4>;
+
+// The HUD of the game screen is drawn in this TrueType font if it is in the
+// asset partition (as raw asset), otherwise in textFont
+#define HUD_FONT_ASSET "hud_font"
+#define HUD_FONT_SIZE 10
+
 ////////////////////////////////////////////////////////////////////////////////
 // Programm entry point definition
 ////////////////////////////////////////////////////////////////////////////////
@@ -99,6 +127,21 @@ class Main final {
         espwifi::wifiController &Wifi = bcd_sys.getWifiController();            /**< WiFi controller */
 
         tetrics_module::board board;
+        bcd_render::display_list<lcd_type, CONFIG_RENDER_DISPLAY_LIST_SIZE,
+            LCD_ROTATION> displayList { lcd };                                  /**< Records and batches all game drawing, composed in panel order */
+        playfield_type playfield;                                               /**< Board cells, one palette index per pixel */
+        preview_type preview;                                                   /**< Cells of the next piece */
+        bcd_render::frame_clock frameClock;                                     /**< Paces the screen loops */
+        bcd_render::quality_governor quality;                                   /**< Render quality of the game screen under load */
+        bcd_render::timeline timeline;                                          /**< Animations of the current screen */
+        bcd_render::image_cache imageCache;                                     /**< Decoded screen images */
+        bcd_render::jpeg_renderer<lcd_type> jpegRenderer { lcd };               /**< Streams images that are not cached, without display list shadow */
+        bcd_render::glyph_cache glyphCache;                                     /**< Expanded font glyphs for text */
+        open_font hudTypeface;                                                  /**< Outlines of the HUD font, read from the asset partition */
+        bcd_render::glyph_atlas hudFont;                                        /**< Rasterised HUD font, initialised if the font is flashed */
+        bcd_render::screen_cache screens;                                       /**< Static parts of the menu screens */
+        bcd_render::particle_system particles;                                  /**< Line clear and drop effects */
+        bcd_assets::asset_partition assets;                                     /**< Images compiled at build time */
 
         //size16 screenSize = size16(0, 0);
         //bmp_type* screen = nullptr;
@@ -127,6 +170,9 @@ class Main final {
         uint previousScoreCount = 0;
 
         void updateInput();
+
+        template<typename Compose>
+        void showScreen(uint8_t id, const srect16 &bounds, Compose compose);
     public:
         enum class GameState
         {
@@ -140,6 +186,7 @@ class Main final {
 
         void run(void);                                                         /**< Main loop */
         void setup(void);                                                       /**< Setup / initialisation code */
+        void prepareScreens(void);                                              /**< Sets up the drawing of the game screens */
 
         GameState runStartScreen();
         GameState runGameScreen();
@@ -148,4 +195,8 @@ class Main final {
         GameState runEndScreen();
 
         void drawJPEG(const char* path, point16 destination);
+        void drawAsset(const char* name, point16 destination);
+        ssize16 measureHudText(const char* text);
+        void drawHudText(const srect16 &rect, const char* text, pixel_type tint);
+        const bcd_render::display_list_stats &renderStatistics() const;        /**< What the game screens sent to the display so far */
 };
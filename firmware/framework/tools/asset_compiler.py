@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Compile images and fonts into the raw asset partition.
+
+    asset_compiler.py assets.json build/assets.bin
+
+The manifest maps asset names to their source and format:
+
+    {
+        "start_screen": {"source": "data/start_screen.jpeg"},
+        "end_screen": {"source": "data/end_screen.jpeg", "format": "rle"},
+        "vga": {"source": "fonts/vga.fon", "format": "raw"}
+    }
+
+Formats:
+
+    rgb565  Panel-ready pixels, high byte first, rows top to bottom. The
+            firmware blits them straight from flash. This is the default.
+    rle     rgb565 compressed with the run length encoding of the
+            screenshot command. Must be decompressed into RAM before use.
+    raw     The file as it is, eg. a .fon font for gfx::font::read(), or
+            the .ttf HUD font ("hud_font") for gfx::open_font::open().
+
+Sources are relative to the manifest. Images need Pillow.
+
+Partition layout (little endian, see components/bcd_assets):
+
+    header  magic "BCDA", u16 version, u16 count, u32 total size
+    entries count times: char name[24], u8 format, u8 reserved,
+            u16 width, u16 height, u16 reserved, u32 offset, u32 length
+    data    every asset 4 byte aligned, offsets from the partition start
+
+Entries are sorted by name, so the firmware can look them up with a
+binary search.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+MAGIC = b"BCDA"
+VERSION = 1
+HEADER = struct.Struct("<4sHHI")
+ENTRY = struct.Struct("<24sBBHHHII")
+NAME_LENGTH = 24
+FORMATS = {"raw": 0, "rgb565": 1, "rle": 2}
+
+
+def load_image(path):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("asset_compiler.py: images need Pillow (pip install pillow)")
+    with Image.open(path) as image:
+        image = image.convert("RGB")
+        return image.width, image.height, image.tobytes()
+
+
+def rgb888_to_rgb565(rgb):
+    out = bytearray(len(rgb) // 3 * 2)
+    for i in range(len(rgb) // 3):
+        r, g, b = rgb[3 * i:3 * i + 3]
+        v = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+        out[2 * i] = v >> 8
+        out[2 * i + 1] = v & 0xFF
+    return bytes(out)
+
+
+def encode_rle(pixels):
+    """Same encoding as the screenshot command: a control byte with the
+    high bit set repeats the next pixel (c & 0x7f) + 1 times, otherwise
+    c + 1 literal pixels follow."""
+    words = [pixels[i:i + 2] for i in range(0, len(pixels), 2)]
+    out = bytearray()
+    i = 0
+    while i < len(words):
+        run = 1
+        while i + run < len(words) and run < 128 \
+                and words[i + run] == words[i]:
+            run += 1
+        if run > 1:
+            out.append(0x80 | (run - 1))
+            out += words[i]
+            i += run
+            continue
+        start = i
+        while i < len(words) and i - start < 128 and \
+                (i + 1 >= len(words) or words[i + 1] != words[i]):
+            i += 1
+        out.append(i - start - 1)
+        out += b"".join(words[start:i])
+    return bytes(out)
+
+
+def compile_asset(name, spec, base):
+    fmt = spec.get("format", "rgb565")
+    if fmt not in FORMATS:
+        sys.exit("%s: unknown format %s" % (name, fmt))
+    if len(name.encode()) >= NAME_LENGTH:
+        sys.exit("%s: name longer than %d characters"
+                 % (name, NAME_LENGTH - 1))
+    path = os.path.join(base, spec["source"])
+    if fmt == "raw":
+        with open(path, "rb") as f:
+            return FORMATS[fmt], 0, 0, f.read()
+    width, height, rgb = load_image(path)
+    pixels = rgb888_to_rgb565(rgb)
+    if fmt == "rle":
+        pixels = encode_rle(pixels)
+    return FORMATS[fmt], width, height, pixels
+
+
+def build(manifest, base):
+    assets = sorted((name, compile_asset(name, spec, base))
+                    for name, spec in manifest.items())
+    start = HEADER.size + ENTRY.size * len(assets)
+    index = b""
+    data = bytearray()
+    for name, (fmt, width, height, payload) in assets:
+        data += b"\0" * (-(start + len(data)) % 4)
+        index += ENTRY.pack(name.encode(), fmt, 0, width, height, 0,
+                            start + len(data), len(payload))
+        data += payload
+        print("%-24s %-6s %4dx%-4d %7d bytes" % (
+              name, [k for k, v in FORMATS.items() if v == fmt][0], width,
+              height, len(payload)))
+    size = start + len(data)
+    return HEADER.pack(MAGIC, VERSION, len(assets), size) + index + data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("manifest", help="JSON manifest of the assets")
+    parser.add_argument("output", help="Partition image to write")
+    parser.add_argument("--size", type=lambda s: int(s, 0),
+                        help="Fail if the image is larger (partition size)")
+    args = parser.parse_args()
+
+    with open(args.manifest) as f:
+        manifest = json.load(f)
+    image = build(manifest, os.path.dirname(os.path.abspath(args.manifest)))
+    if args.size is not None and len(image) > args.size:
+        sys.exit("Assets need %d bytes, partition has %d"
+                 % (len(image), args.size))
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("%s: %d assets, %d bytes" % (args.output, len(manifest),
+                                       len(image)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Compare screenshot captures against reference frames.
+
+Play a fixed sequence with a fixed CONFIG_GAME_RANDOM_SEED, take screenshots
+at the points of interest and save the console log. Then:
+
+    compare_frames.py console.log references/            # check
+    compare_frames.py --update console.log references/   # accept new frames
+
+The n-th capture in the log is compared with references/frame_<n>.png.
+A reference can also be a text dump with one #rrggbb value per line, like
+output.txt (pass --width/--height if it is not 128x160).
+
+If the firmware was built with CONFIG_RENDER_LOG_STATS, the flush statistics
+in the log are summed up and compared with references/stats.json, so the
+bus savings of a renderer change can be read off next to the proof that the
+frames did not change.
+
+Exits with 1 if a frame differs.
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import screenshot  # noqa: E402
+
+# Logs from before RGB444 output have no packed pixel count
+STATS = re.compile(rb"flush (\d+): (\d+) primitives, (\d+) windows, "
+                   rb"(\d+) px(?: \((\d+) RGB444\))?, (\d+) scrolls")
+STAT_KEYS = ("flushes", "primitives", "windows", "pixels", "packed",
+             "scrolls")
+
+
+def read_png(path):
+    """Reads 8 bit RGB or RGBA PNGs without interlacing."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("%s: not a PNG" % path)
+    offset = 8
+    idat = b""
+    while offset < len(data):
+        length, kind = struct.unpack_from(">I4s", data, offset)
+        body = data[offset + 8:offset + 8 + length]
+        if kind == b"IHDR":
+            width, height, depth, ctype, _, _, interlace = \
+                struct.unpack(">IIBBBBB", body)
+            if depth != 8 or ctype not in (2, 6) or interlace:
+                raise ValueError("%s: unsupported PNG format" % path)
+        elif kind == b"IDAT":
+            idat += body
+        offset += 12 + length
+
+    bpp = 3 if ctype == 2 else 4
+    stride = width * bpp
+    raw = zlib.decompress(idat)
+    rgb = bytearray()
+    prev = bytearray(stride)
+    for y in range(height):
+        ftype = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for x in range(stride):
+            a = line[x - bpp] if x >= bpp else 0
+            b = prev[x]
+            c = prev[x - bpp] if x >= bpp else 0
+            if ftype == 1:
+                line[x] = (line[x] + a) & 0xFF
+            elif ftype == 2:
+                line[x] = (line[x] + b) & 0xFF
+            elif ftype == 3:
+                line[x] = (line[x] + (a + b) // 2) & 0xFF
+            elif ftype == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else b if pb <= pc else c
+                line[x] = (line[x] + pred) & 0xFF
+        for x in range(width):
+            rgb += line[x * bpp:x * bpp + 3]
+        prev = line
+    return width, height, bytes(rgb)
+
+
+def read_text_dump(path, width, height):
+    rgb = bytearray()
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line:
+                rgb += bytes.fromhex(line.lstrip("#"))
+    if len(rgb) != width * height * 3:
+        raise ValueError("%s: %d pixels, expected %dx%d"
+                         % (path, len(rgb) // 3, width, height))
+    return width, height, bytes(rgb)
+
+
+def read_reference(path, width, height):
+    if path.endswith(".png"):
+        return read_png(path)
+    return read_text_dump(path, width, height)
+
+
+def compare(frame, reference):
+    """Returns the number of differing pixels and their bounding box."""
+    (w, h, rgb), (rw, rh, ref) = frame, reference
+    if (w, h) != (rw, rh):
+        return w * h, None
+    diff = 0
+    box = None
+    for i in range(w * h):
+        if rgb[3 * i:3 * i + 3] != ref[3 * i:3 * i + 3]:
+            diff += 1
+            x, y = i % w, i // w
+            if box is None:
+                box = [x, y, x, y]
+            else:
+                box = [min(box[0], x), min(box[1], y),
+                       max(box[2], x), max(box[3], y)]
+    return diff, box
+
+
+def sum_stats(log):
+    totals = dict.fromkeys(STAT_KEYS, 0)
+    for m in STATS.finditer(log):
+        totals["flushes"] += 1
+        for key, value in zip(STAT_KEYS[1:], m.groups()[1:]):
+            totals[key] += int(value or 0)
+    return totals
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", help="Console log with screenshot captures")
+    parser.add_argument("references", help="Directory of reference frames")
+    parser.add_argument("--update", action="store_true",
+                        help="Replace the references with the captures")
+    parser.add_argument("--width", type=int, default=128)
+    parser.add_argument("--height", type=int, default=160)
+    args = parser.parse_args()
+
+    with open(args.log, "rb") as f:
+        log = f.read()
+    frames = [(w, h, screenshot.rgb565_to_rgb888(p))
+              for w, h, p in screenshot.find_frames(log)]
+    stats = sum_stats(log)
+    stats_path = os.path.join(args.references, "stats.json")
+
+    if args.update:
+        os.makedirs(args.references, exist_ok=True)
+        for n, (w, h, rgb) in enumerate(frames):
+            screenshot.write_png(os.path.join(args.references,
+                                 "frame_%03d.png" % n), w, h, rgb)
+        if stats["flushes"]:
+            with open(stats_path, "w") as f:
+                json.dump(stats, f, indent=4)
+        print("Stored %d frames" % len(frames))
+        return 0
+
+    references = sorted(glob.glob(os.path.join(args.references, "frame_*")))
+    failed = len(frames) != len(references)
+    if failed:
+        print("%d captures, %d references" % (len(frames), len(references)))
+
+    for n, (frame, path) in enumerate(zip(frames, references)):
+        diff, box = compare(frame, read_reference(path, args.width,
+                                                  args.height))
+        if diff:
+            failed = True
+            print("frame %d: %d pixels differ from %s (box %s)"
+                  % (n, diff, os.path.basename(path), box))
+        else:
+            print("frame %d: identical" % n)
+
+    if stats["flushes"]:
+        baseline = None
+        if os.path.exists(stats_path):
+            with open(stats_path) as f:
+                baseline = json.load(f)
+        for key in STAT_KEYS:
+            line = "%-10s %10d" % (key, stats[key])
+            if baseline and baseline.get(key):
+                line += "  (%+.1f%%)" % (100.0 * (stats[key] - baseline[key])
+                                         / baseline[key])
+            print(line)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
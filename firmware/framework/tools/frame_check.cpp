@@ -0,0 +1,340 @@
+/**
+ * @file    frame_check.cpp
+ * @brief   Host regression check of the display list
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Plays a script of frames through bcd_render::display_list into an
+ * emulated ST7735 and checks what the panel shows after every frame:
+ *
+ *  - it must be what the shadow framebuffer holds,
+ *  - the game's setup (LCD_ROTATION 3, frames written in the panel's native
+ *    scan order) must show the same as the driver drawing every window
+ *    itself,
+ *  - a hash of it and the statistics of the last flush must match
+ *    tools/host/frame_check.ref.
+ *
+ * The emulated panel (tools/host/emulated_panel.hpp) keeps its memory in
+ * a gfx bitmap and takes commands through send_command()/send_data() like
+ * espidf::st7735, so panel_io is used unchanged. It honours MADCTL, the
+ * address window, the 12 bit interface mode and the vertical scroll
+ * registers, and reports everything the display list should never do, like
+ * writing past a window or drawing through the driver with the panel left
+ * in native scan order.
+ *
+ * The frames only use primitives bcd_render rasterises itself (fills,
+ * blends, bitmaps, indexed surfaces, single pixels and scrolling), so the
+ * references do not depend on the gfx version. tools/host has stand-ins
+ * for the ESP-IDF headers the render component includes.
+ *
+ * tools/make_references.sh builds this check and tools/screen_check.cpp
+ * against the gfx submodules and runs both. A frame that differs from its
+ * reference is written as frame_check_<run>_<frame>.ppm. After an intended
+ * change, accept the new frames with
+ *
+ *      tools/make_references.sh --update
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "bcd_display_list.hpp"
+#include "emulated_panel.hpp"
+
+static const char *REFERENCES = "tools/host/frame_check.ref";
+
+static pixel rgb565(uint16_t value) {
+    pixel p;
+    p.native_value = value;
+    return p;
+}
+
+// A colour that survives the 12 bit interface mode unchanged
+static pixel rgb444(uint8_t r, uint8_t g, uint8_t b) {
+    return rgb565(((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5)
+        | (b << 1 | b >> 3));
+}
+
+/**
+ * @brief The shadow framebuffer of a display list, in screen orientation
+ */
+template<typename List>
+static void surface(const List &list, frame_type &screen) {
+    const frame_type *shadow = list.framebuffer();
+    const gfx::size16 native = shadow->dimensions();
+    const gfx::size16 size = list.dimensions();
+    uint8_t *out = screen.begin();
+    for(uint16_t y = 0; y < size.height; y++) {
+        for(uint16_t x = 0; x < size.width; x++, out += 2) {
+            const gfx::spoint16 n = List::transform::point(
+                gfx::spoint16(x, y), native);
+            const uint8_t *p = shadow->begin() + (n.y * native.width + n.x)
+                * 2;
+            out[0] = p[0];
+            out[1] = p[1];
+        }
+    }
+}
+
+/**
+ * @brief The scripted frames, laid out for the 160x128 screen of the game
+ *
+ * The playfield area is sent as RGB444 from frame 2 to 6 and only gets
+ * colours that survive it. scroll() flushes by itself, so a frame that
+ * scrolls ends with it and its statistics are the ones of the scroll.
+ */
+template<typename List>
+static void play(List &list, int frame) {
+    static const gfx::srect16 playfield(55, 10, 104, 119);
+    static uint16_t tile[12 * 7];
+    static frame_type tileBitmap(gfx::size16(12, 7), tile);
+    static gfx::const_bitmap<pixel> constTile(gfx::size16(12, 7), tile);
+    static bcd_render::indexed_surface field;
+    static bcd_render::indexed_palette palette;
+    static int16_t xs[16];
+    static int16_t ys[16];
+    static pixel previous[16];
+
+    if(!field.initialized()) {
+        for(size_t i = 0; i < sizeof(tile) / sizeof(tile[0]); i++) {
+            tile[i] = (uint16_t)(i * 2053 + 97);
+        }
+        field.initialize(gfx::size16(50, 110));
+        for(uint8_t i = 0; i < 16; i++) {
+            palette.set(i, rgb444(i, 15 - i, (i * 5) & 15));
+        }
+        for(uint16_t i = 0; i < 11; i++) {
+            field.fill(gfx::rect16(i * 4, i * 9, i * 4 + 9, i * 9 + 14),
+                i + 1);
+        }
+    }
+
+    switch(frame) {
+        case 0:
+            // Background, partly off screen
+            list.filled_rectangle((gfx::srect16)list.bounds(),
+                rgb565(0x18e3));
+            list.filled_rectangle(playfield, rgb444(1, 1, 2));
+            list.filled_rectangle(gfx::srect16(-5, -5, 10, 3),
+                rgb565(0xf800));
+            list.filled_rectangle(gfx::srect16(150, 100, 170, 140),
+                rgb565(0x07e0));
+            list.filled_rectangle(gfx::srect16(3, 20, 4, 90),
+                rgb565(0xffe0));
+            break;
+        case 1:
+            // Bitmaps and a dimmed dialog
+            list.bitmap(gfx::srect16(150, 120, 161, 126), tileBitmap,
+                tileBitmap.bounds());
+            list.bitmap(gfx::srect16(3, 100, 14, 106), constTile,
+                gfx::rect16(0, 0, 11, 6));
+            list.blend(gfx::srect16(20, 30, 90, 70), rgb565(0x001f), 128);
+            list.blend(gfx::srect16(0, 0, 159, 8), rgb565(0xffff), 40);
+            break;
+        case 2:
+            // The playfield, as RGB444
+            list.enable_rgb444(playfield);
+            list.indexed(playfield, field, field.bounds(), palette);
+            break;
+        case 3:
+            // Particles
+            for(int16_t i = 0; i < 16; i++) {
+                xs[i] = 20 + i * 9;
+                ys[i] = 5 + (i * 37) % 118;
+            }
+            // The last one is off screen
+            xs[15] = 170;
+            {
+                pixel colors[16];
+                for(int i = 0; i < 16; i++) {
+                    colors[i] = rgb444(15, i, 0);
+                }
+                list.points(xs, ys, colors, 16, previous);
+            }
+            break;
+        case 4:
+            // The particles go away again
+            list.points(xs, ys, previous, 16);
+            list.filled_rectangle(gfx::srect16(60, 50, 64, 54),
+                rgb444(15, 15, 15));
+            break;
+        case 5:
+            // A line clear moves the playfield down
+            list.scroll((gfx::rect16)playfield, 5);
+            return;
+        case 6:
+            // New rows at the top, and more primitives than the list holds
+            list.filled_rectangle(gfx::srect16(55, 10, 104, 14),
+                rgb444(0, 0, 0));
+            for(int i = 0; i < 80; i++) {
+                const int16_t x = (i * 23) % 150;
+                const int16_t y = (i * 11) % 120;
+                list.filled_rectangle(gfx::srect16(x, y, x + 6, y + 4),
+                    rgb444(i & 15, (i >> 2) & 15, 15 - (i & 15)));
+            }
+            break;
+        case 7:
+            // Back to 16 bit, drawing through compose()
+            list.disable_rgb444();
+            list.compose(gfx::srect16(0, 0, 49, 20), [](auto &target) {
+                return bcd_render::fill(target, gfx::srect16(0, 0, 49, 20),
+                    rgb565(0x8410));
+            });
+            list.filled_rectangle(gfx::srect16(70, 40, 80, 45),
+                rgb565(0x1234));
+            break;
+        case 8:
+            // Another band scrolls
+            list.scroll(gfx::rect16(0, 0, 159, 40), 3);
+            return;
+        case 9:
+            list.filled_rectangle(gfx::srect16(0, 0, 159, 2),
+                rgb565(0xabcd));
+            break;
+    }
+    list.flush();
+}
+
+static constexpr int FRAMES = 10;
+
+struct run_result {
+    std::vector<std::string> lines;
+    std::vector<std::vector<uint8_t>> frames;
+    bool ok = true;
+};
+
+template<uint8_t PanelRotation, uint8_t ListRotation>
+static run_result run(const char *name, bool hardwareScroll) {
+    using panel_type = emulated_panel<PanelRotation>;
+    using list_type = bcd_render::display_list<panel_type,
+        CONFIG_RENDER_DISPLAY_LIST_SIZE, ListRotation>;
+    static panel_type panel;
+    static list_type list(panel);
+    run_result result;
+
+    if(list.initialize() != RENDER_OK) {
+        printf("%s: no shadow framebuffer\n", name);
+        result.ok = false;
+        return result;
+    }
+    if(hardwareScroll) {
+        list.enable_hardware_scroll(NATIVE_HEIGHT);
+    }
+
+    static uint8_t shownPixels[FRAME_SIZE];
+    static uint8_t shadowPixels[FRAME_SIZE];
+    frame_type shown(panel.dimensions(), shownPixels);
+    frame_type shadow(panel.dimensions(), shadowPixels);
+    for(int frame = 0; frame < FRAMES; frame++) {
+        play(list, frame);
+        if(!panel.ready()) {
+            printf("%s %d: panel left in another mode\n", name, frame);
+            result.ok = false;
+        }
+        panel.shown(shown);
+        surface(list, shadow);
+        if(memcmp(shownPixels, shadowPixels, FRAME_SIZE) != 0) {
+            printf("%s %d: panel differs from the shadow framebuffer\n",
+                name, frame);
+            result.ok = false;
+        }
+
+        const bcd_render::display_list_stats &s = list.lastFlush();
+        char line[160];
+        snprintf(line, sizeof(line), "%s %d: %08x, %u primitives, "
+            "%u windows, %u px (%u RGB444), %u scrolls", name, frame,
+            (unsigned)hash(shownPixels, FRAME_SIZE), (unsigned)s.primitives,
+            (unsigned)s.windows, (unsigned)s.pixels, (unsigned)s.packed,
+            (unsigned)s.scrolls);
+        result.lines.push_back(line);
+        result.frames.emplace_back(shownPixels, shownPixels + FRAME_SIZE);
+    }
+    if(panel.faults() != 0) {
+        printf("%s: %u panel faults\n", name, panel.faults());
+        result.ok = false;
+    }
+    return result;
+}
+
+int main(int argc, char **argv) {
+    bool update = false;
+    const char *path = REFERENCES;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    // The game's setup, the same frames through the driver, and a panel
+    // that scrolls along screen rows
+    const char *names[] = { "game", "driver", "scroll" };
+    run_result runs[] = {
+        run<3, 3>(names[0], false),
+        run<3, 0>(names[1], false),
+        run<0, 0>(names[2], true),
+    };
+    bool ok = true;
+    for(const run_result &r : runs) {
+        ok = ok && r.ok;
+    }
+    for(int frame = 0; frame < FRAMES; frame++) {
+        if(runs[0].frames[frame] != runs[1].frames[frame]) {
+            printf("frame %d: native writes differ from the driver's\n",
+                frame);
+            ok = false;
+        }
+    }
+
+    if(update) {
+        FILE *f = fopen(path, "w");
+        if(f == nullptr) {
+            printf("Cannot write %s\n", path);
+            return 1;
+        }
+        for(const run_result &r : runs) {
+            for(const std::string &line : r.lines) {
+                fprintf(f, "%s\n", line.c_str());
+            }
+        }
+        fclose(f);
+        printf("%s updated\n", path);
+        return ok ? 0 : 1;
+    }
+
+    FILE *f = fopen(path, "r");
+    if(f == nullptr) {
+        printf("Cannot read %s, make it with tools/make_references.sh "
+            "--update\n", path);
+        return 1;
+    }
+    char expected[160];
+    for(size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        for(int frame = 0; frame < FRAMES; frame++) {
+            const std::string &actual = runs[i].lines[frame];
+            if(fgets(expected, sizeof(expected), f) == nullptr) {
+                expected[0] = '\0';
+            }
+            expected[strcspn(expected, "\n")] = '\0';
+            if(actual == expected) {
+                continue;
+            }
+            printf("expected %s\n     got %s\n", expected, actual.c_str());
+            char ppm[64];
+            snprintf(ppm, sizeof(ppm), "frame_check_%s_%d.ppm", names[i],
+                frame);
+            const gfx::size16 size = i == 2 ? gfx::size16(NATIVE_WIDTH,
+                NATIVE_HEIGHT) : gfx::size16(NATIVE_HEIGHT, NATIVE_WIDTH);
+            writePpm(ppm, frame_type(size,
+                (void *)runs[i].frames[frame].data()));
+            ok = false;
+        }
+    }
+    fclose(f);
+    printf(ok ? "All frames match\n" : "Frames differ\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,2 @@
+// Host stand-in for FreeRTOSConfig.h, see tools/screen_check.cpp
+#pragma once
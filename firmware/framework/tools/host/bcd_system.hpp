@@ -0,0 +1,69 @@
+// Host stand-in for bcd_system.hpp, see tools/screen_check.cpp. The display
+// is an emulated ST7735 and the controller plays the check's script.
+#pragma once
+
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "gfx.hpp"
+#include "st7735_bcd.hpp"
+#include "emulated_panel.hpp"
+
+#define LCD_WIDTH       CONFIG_LCD_WIDTH
+#define LCD_HEIGHT      CONFIG_LCD_HEIGHT
+#define LCD_ROTATION    CONFIG_LCD_ROTATION
+
+using lcd_type = emulated_panel<LCD_ROTATION>;
+using lcd_color = gfx::color<typename lcd_type::pixel_type>;
+
+enum : uint16_t {
+    BUTTON_UP = 1 << 0,
+    BUTTON_DOWN = 1 << 1,
+    BUTTON_LEFT = 1 << 2,
+    BUTTON_RIGHT = 1 << 3,
+    BUTTON_A = 1 << 4,
+    BUTTON_B = 1 << 5,
+    BUTTON_X = 1 << 6,
+    BUTTON_Y = 1 << 7,
+};
+
+class controllerDriver {
+    public:
+        void clear() {}
+        void capture();                                                         /**< Takes the next step of the script */
+        bool getButtonState(uint16_t button) const {
+            return (buttons & button) != 0;
+        }
+
+        uint16_t buttons = 0;                                                   /**< Buttons held in this step */
+};
+
+namespace espconsole {
+class consoleController {};
+} // namespace espconsole
+
+namespace espwifi {
+class wifiController {
+    public:
+        enum class state_e {
+            NOT_INITIALIZED,
+        };
+};
+} // namespace espwifi
+
+class bcd_system {
+    public:
+        lcd_type &getDisplay() { return lcd; }
+        controllerDriver &getControllerDriver() { return controller; }
+        espconsole::consoleController &getConsoleController() {
+            return console;
+        }
+        espwifi::wifiController &getWifiController() { return wifi; }
+
+    private:
+        lcd_type lcd;
+        controllerDriver controller;
+        espconsole::consoleController console;
+        espwifi::wifiController wifi;
+};
+
+extern bcd_system bcd_sys;
@@ -0,0 +1,5 @@
+// Host stand-in for the ch405labs debug component, see
+// tools/screen_check.cpp
+#pragma once
+
+static const char TAG_STACK[] = "Stack";
@@ -0,0 +1,3 @@
+// Host stand-in for cmd_screenshot.hpp, see tools/screen_check.cpp. The game
+// screens do not use it.
+#pragma once
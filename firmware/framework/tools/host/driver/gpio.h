@@ -0,0 +1,16 @@
+// Host stand-in for driver/gpio.h, see tools/frame_check.cpp
+#pragma once
+
+#include "esp_lcd_panel_io.h"
+
+typedef enum {
+    GPIO_NUM_NC = -1,
+} gpio_num_t;
+
+typedef enum {
+    GPIO_MODE_OUTPUT = 2,
+} gpio_mode_t;
+
+esp_err_t gpio_reset_pin(gpio_num_t pin);
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode);
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level);
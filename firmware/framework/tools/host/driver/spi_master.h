@@ -0,0 +1,8 @@
+// Host stand-in for driver/spi_master.h, see tools/frame_check.cpp
+#pragma once
+
+typedef enum {
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2,
+} spi_host_device_t;
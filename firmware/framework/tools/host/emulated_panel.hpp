@@ -0,0 +1,300 @@
+// Host stand-in for the ST7735, shared by tools/frame_check.cpp and
+// tools/screen_check.cpp
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "gfx.hpp"
+#include "bcd_panel.hpp"
+#include "bcd_orientation.hpp"
+
+using pixel = gfx::rgb_pixel<16>;
+using frame_type = gfx::bitmap<pixel>;
+
+static constexpr uint16_t NATIVE_WIDTH = 128;
+static constexpr uint16_t NATIVE_HEIGHT = 160;
+static constexpr size_t FRAME_SIZE = NATIVE_WIDTH * NATIVE_HEIGHT * 2;
+
+// Native position of a point in the layout of a rotation
+inline gfx::spoint16 toNative(uint8_t rotation, const gfx::spoint16 &p) {
+    const gfx::size16 native(NATIVE_WIDTH, NATIVE_HEIGHT);
+    switch(rotation & 3) {
+        case 1:
+            return bcd_render::orientation<1>::point(p, native);
+        case 2:
+            return bcd_render::orientation<2>::point(p, native);
+        case 3:
+            return bcd_render::orientation<3>::point(p, native);
+        default:
+            return p;
+    }
+}
+
+/**
+ * @brief An ST7735 with a 128x160 panel, driven with rotation Rotation
+ *
+ * A gfx draw target in screen coordinates for what the driver draws, and
+ * the command interface of the driver for panel_io.
+ */
+template<uint8_t Rotation>
+class emulated_panel {
+    public:
+        using type = emulated_panel;
+        using pixel_type = pixel;
+        using caps = gfx::gfx_caps<false, false, false, false, false, false,
+            false>;
+
+        emulated_panel() : memory(gfx::size16(NATIVE_WIDTH, NATIVE_HEIGHT),
+            ram) {}
+
+        gfx::size16 dimensions() const {
+            return bcd_render::orientation<Rotation>::layout(
+                memory.dimensions());
+        }
+        gfx::rect16 bounds() const { return dimensions().bounds(); }
+
+        gfx::gfx_result point(gfx::point16 location, pixel_type color) {
+            if(location.x >= dimensions().width
+                    || location.y >= dimensions().height) {
+                return gfx::gfx_result::success;
+            }
+            if(madctl != bcd_render::st7735_madctl(Rotation) || bits != 16) {
+                fault("driver draws with the panel in another mode");
+            }
+            store(toNative(Rotation, gfx::spoint16(location.x, location.y)),
+                color.native_value);
+            return gfx::gfx_result::success;
+        }
+
+        gfx::gfx_result fill(const gfx::rect16 &r, pixel_type color) {
+            for(uint16_t y = r.top(); y <= r.bottom(); y++) {
+                for(uint16_t x = r.left(); x <= r.right(); x++) {
+                    point(gfx::point16(x, y), color);
+                }
+            }
+            return gfx::gfx_result::success;
+        }
+
+        gfx::gfx_result clear(const gfx::rect16 &r) {
+            return fill(r, gfx::color<pixel_type>::black);
+        }
+
+        espidf::spi_result send_command(uint8_t cmd) {
+            endPixels();
+            command = cmd;
+            params = 0;
+            if(cmd == ST7735_RAMWR) {
+                // The window is in the layout of the current scan order
+                scan = 4;
+                for(uint8_t r = 0; r < 4; r++) {
+                    if(madctl == bcd_render::st7735_madctl(r)) {
+                        scan = r;
+                    }
+                }
+                if(scan == 4) {
+                    fault("memory write with an unknown MADCTL");
+                }
+                cursor = gfx::spoint16(window.x1, window.y1);
+            } else if(cmd == ST7735_NORON) {
+                scrolling = false;
+            }
+            return espidf::spi_result::success;
+        }
+
+        espidf::spi_result send_data(const uint8_t *data, size_t size) {
+            if(command == ST7735_RAMWR) {
+                for(size_t i = 0; i < size; i++) {
+                    pending[pendingBytes++] = data[i];
+                    if(bits == 16 && pendingBytes == 2) {
+                        write((pending[0] << 8) | pending[1]);
+                        pendingBytes = 0;
+                    } else if(bits == 12 && pendingBytes == 3) {
+                        write(widen((pending[0] << 4) | (pending[1] >> 4)));
+                        write(widen(((pending[1] & 0x0f) << 8) | pending[2]));
+                        pendingBytes = 0;
+                    }
+                }
+                return espidf::spi_result::success;
+            }
+            for(size_t i = 0; i < size && params < sizeof(param); i++) {
+                param[params++] = data[i];
+            }
+            switch(command) {
+                case ST7735_MADCTL:
+                    madctl = param[0];
+                    break;
+                case ST7735_COLMOD:
+                    bits = param[0] == ST7735_COLMOD_12BIT ? 12 : 16;
+                    break;
+                case ST7735_CASET:
+                    if(params == 4) {
+                        window.x1 = (param[0] << 8) | param[1];
+                        window.x2 = (param[2] << 8) | param[3];
+                    }
+                    break;
+                case ST7735_RASET:
+                    if(params == 4) {
+                        window.y1 = (param[0] << 8) | param[1];
+                        window.y2 = (param[2] << 8) | param[3];
+                    }
+                    break;
+                case ST7735_VSCRDEF:
+                    if(params == 6) {
+                        top = (param[0] << 8) | param[1];
+                        lines = (param[2] << 8) | param[3];
+                        const uint16_t bottom = (param[4] << 8) | param[5];
+                        if(top + lines + bottom != NATIVE_HEIGHT
+                                || lines == 0) {
+                            fault("scroll area does not add up to the panel");
+                            lines = 0;
+                        }
+                    }
+                    break;
+                case ST7735_VSCSAD:
+                    if(params == 2) {
+                        start = (param[0] << 8) | param[1];
+                        scrolling = lines != 0;
+                    }
+                    break;
+            }
+            return espidf::spi_result::success;
+        }
+
+        /**
+         * @brief What the panel shows, in screen orientation
+         */
+        void shown(frame_type &screen) const {
+            const uint8_t *mem = memory.begin();
+            uint8_t *out = screen.begin();
+            const gfx::size16 size = dimensions();
+            for(uint16_t y = 0; y < size.height; y++) {
+                for(uint16_t x = 0; x < size.width; x++, out += 2) {
+                    const gfx::spoint16 n = toNative(Rotation,
+                        gfx::spoint16(x, y));
+                    uint16_t line = n.y;
+                    if(scrolling && line >= top && line < top + lines) {
+                        line = top + (start - top + line - top) % lines;
+                    }
+                    const uint8_t *p = mem + (line * NATIVE_WIDTH + n.x) * 2;
+                    out[0] = p[0];
+                    out[1] = p[1];
+                }
+            }
+        }
+
+        /**
+         * @brief The driver can draw: the panel is in its scan order and
+         *      takes 16 bit pixels
+         */
+        bool ready() const {
+            return madctl == bcd_render::st7735_madctl(Rotation) && bits == 16
+                && (command != ST7735_RAMWR || pendingBytes == 0);
+        }
+
+        unsigned faults() const { return faultCount; }
+
+        /**
+         * @brief Pixels written so far, through the driver and memory writes
+         */
+        uint32_t writes() const { return writeCount; }
+
+    private:
+        uint8_t ram[FRAME_SIZE] = { 0 };
+        frame_type memory;
+
+        uint8_t madctl = bcd_render::st7735_madctl(Rotation);
+        uint8_t bits = 16;
+        uint8_t command = 0;
+        uint8_t param[6] = { 0 };
+        size_t params = 0;
+
+        // Memory write in progress
+        gfx::rect16 window;
+        uint8_t scan = 0;                                                       /**< Rotation of the scan order */
+        gfx::spoint16 cursor;
+        uint8_t pending[3];
+        size_t pendingBytes = 0;
+
+        // Vertical scrolling, in panel lines
+        bool scrolling = false;
+        uint16_t top = 0;
+        uint16_t lines = 0;
+        uint16_t start = 0;
+
+        unsigned faultCount = 0;
+        uint32_t writeCount = 0;
+
+        void fault(const char *what) {
+            if(faultCount++ < 10) {
+                printf("panel: %s\n", what);
+            }
+        }
+
+        // The controller widens every channel by repeating its upper bits
+        static uint16_t widen(uint16_t c) {
+            const uint16_t r = c >> 8;
+            const uint16_t g = (c >> 4) & 0x0f;
+            const uint16_t b = c & 0x0f;
+            return ((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5)
+                | (b << 1 | b >> 3);
+        }
+
+        void store(const gfx::spoint16 &n, uint16_t value) {
+            uint8_t *p = memory.begin() + (n.y * NATIVE_WIDTH + n.x) * 2;
+            p[0] = value >> 8;
+            p[1] = value & 0xff;
+            writeCount++;
+        }
+
+        void write(uint16_t value) {
+            if(scan == 4) {
+                return;
+            }
+            if(cursor.y > window.y2) {
+                fault("more pixels than the window holds");
+                return;
+            }
+            store(toNative(scan, cursor), value);
+            if(++cursor.x > window.x2) {
+                cursor.x = window.x1;
+                cursor.y++;
+            }
+        }
+
+        // An odd number of RGB444 pixels ends with half a byte of padding
+        void endPixels() {
+            if(command == ST7735_RAMWR && bits == 12 && pendingBytes == 2) {
+                write(widen((pending[0] << 4) | (pending[1] >> 4)));
+            } else if(command == ST7735_RAMWR && pendingBytes != 0) {
+                fault("memory write ends within a pixel");
+            }
+            pendingBytes = 0;
+        }
+};
+
+// FNV-1a, to keep the references short
+inline uint32_t hash(const uint8_t *data, size_t size) {
+    uint32_t h = 2166136261u;
+    for(size_t i = 0; i < size; i++) {
+        h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+}
+
+inline void writePpm(const char *path, const frame_type &frame) {
+    FILE *f = fopen(path, "wb");
+    if(f == nullptr) {
+        return;
+    }
+    const gfx::size16 size = frame.dimensions();
+    fprintf(f, "P6\n%u %u\n255\n", size.width, size.height);
+    const uint8_t *p = frame.begin();
+    for(size_t i = 0; i < (size_t)size.width * size.height; i++, p += 2) {
+        const uint16_t v = (p[0] << 8) | p[1];
+        const uint8_t rgb[3] = { (uint8_t)((v >> 11) * 255 / 31),
+            (uint8_t)(((v >> 5) & 0x3f) * 255 / 63),
+            (uint8_t)((v & 0x1f) * 255 / 31) };
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+    fclose(f);
+}
@@ -0,0 +1,4 @@
+// Host stand-in for esp_attr.h, see tools/frame_check.cpp
+#pragma once
+
+#define IRAM_ATTR
@@ -0,0 +1,10 @@
+// Host stand-in for esp_err.h, see tools/frame_check.cpp
+#pragma once
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+static inline const char *esp_err_to_name(esp_err_t) {
+    return "error";
+}
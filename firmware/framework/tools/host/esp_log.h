@@ -0,0 +1,12 @@
+// Host stand-in for esp_log.h, see tools/frame_check.cpp
+#pragma once
+
+#include <stdio.h>
+
+#define ESP_LOG_HOST(level, tag, format, ...) \
+    printf(level " (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGE(tag, format, ...) ESP_LOG_HOST("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_HOST("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_HOST("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)
+#define ESP_LOGV(tag, format, ...)
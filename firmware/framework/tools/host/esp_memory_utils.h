@@ -0,0 +1,4 @@
+// Host stand-in for esp_memory_utils.h, see tools/frame_check.cpp
+#pragma once
+
+bool esp_ptr_dma_capable(const void *ptr);
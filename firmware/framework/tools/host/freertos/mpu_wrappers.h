@@ -0,0 +1,2 @@
+// Host stand-in for freertos/mpu_wrappers.h, see tools/screen_check.cpp
+#pragma once
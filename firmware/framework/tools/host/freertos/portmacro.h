@@ -0,0 +1,4 @@
+// Host stand-in for freertos/portmacro.h, see tools/screen_check.cpp
+#pragma once
+
+#include "FreeRTOS.h"
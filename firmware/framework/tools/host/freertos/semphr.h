@@ -0,0 +1,12 @@
+// Host stand-in for freertos/semphr.h, see tools/frame_check.cpp
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef struct semaphore_t *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore,
+    BaseType_t *woken);
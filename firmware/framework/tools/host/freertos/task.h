@@ -0,0 +1,12 @@
+// Host stand-in for freertos/task.h, see tools/frame_check.cpp
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef struct task_t *TaskHandle_t;
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+void xTaskNotifyGive(TaskHandle_t task);
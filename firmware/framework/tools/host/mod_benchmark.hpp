@@ -0,0 +1,3 @@
+// Host stand-in for mod_benchmark.hpp, see tools/screen_check.cpp. The game
+// screens do not use it.
+#pragma once
@@ -0,0 +1,31 @@
+// Host stand-in for the generated sdkconfig.h, see tools/frame_check.cpp.
+// The render and asset options are the Kconfig defaults of bcd_render and
+// bcd_assets, the game options those of src/Kconfig.projbuild.
+#pragma once
+
+#define CONFIG_TAG_RENDER "RENDER"
+#define CONFIG_RENDER_DISPLAY_LIST_SIZE 64
+#define CONFIG_RENDER_TEXT_LENGTH 24
+#define CONFIG_RENDER_DIRTY_RECTS 16
+#define CONFIG_RENDER_WINDOW_COST_PX 64
+#define CONFIG_RENDER_SHADOW_IN_PSRAM 1
+#define CONFIG_RENDER_GLYPH_CACHE_ENTRIES 64
+#define CONFIG_RENDER_FRAME_RATE 60
+#define CONFIG_RENDER_QUALITY_HIGH_LOAD 90
+#define CONFIG_RENDER_QUALITY_LOW_LOAD 60
+#define CONFIG_RENDER_QUALITY_RECOVER 30
+#define CONFIG_RENDER_TWEENS 16
+#define CONFIG_RENDER_PARTICLES 128
+#define CONFIG_RENDER_IMAGE_CACHE_KB 160
+#define CONFIG_RENDER_IMAGE_CACHE_ENTRIES 4
+#define CONFIG_RENDER_SCREEN_CACHE_ENTRIES 4
+
+#define CONFIG_TAG_ASSETS "ASSETS"
+#define CONFIG_ASSETS_PARTITION_LABEL "assets"
+
+#define CONFIG_DISPLAY_SUPPORT 1
+#define CONFIG_LCD_WIDTH 128
+#define CONFIG_LCD_HEIGHT 160
+#define CONFIG_LCD_ROTATION 3
+#define CONFIG_CH405LABS_CONTROLLER_SUPPORT 1
+#define CONFIG_GAME_RANDOM_SEED 1
@@ -0,0 +1,12 @@
+// Host stand-in for the ch405labs ST7735 driver, see tools/frame_check.cpp.
+// bcd_panel.hpp only needs the result type of its command interface.
+#pragma once
+
+namespace espidf {
+
+enum struct spi_result {
+    success = 0,
+    io_error
+};
+
+} // namespace espidf
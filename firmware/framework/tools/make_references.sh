@@ -0,0 +1,61 @@
+#!/bin/sh
+# Builds the host checks of the display list (tools/frame_check.cpp) and of
+# the game screens (tools/screen_check.cpp) against the gfx submodules and
+# runs them. With --update they write new references to tools/host instead
+# of comparing with them.
+#
+#     tools/make_references.sh [--update]
+#
+# Needs the submodules checked out (git submodule update --init), a host
+# g++ and Python with Pillow for tools/asset_compiler.py. The binaries and
+# the asset partition go to $BUILD, .pio/host unless set.
+set -e
+
+cd "$(dirname "$0")/.."
+if [ ! -f components/gfx/include/gfx.hpp ]; then
+    echo "The gfx submodule is missing, run git submodule update --init" >&2
+    exit 1
+fi
+
+BUILD=${BUILD:-.pio/host}
+mkdir -p "$BUILD"
+
+GFX="-Icomponents/gfx/include -Icomponents/htcw_bits/include
+    -Icomponents/htcw_io/include -Icomponents/htcw_data/include
+    -Icomponents/htcw_ml/include"
+GFX_SOURCES=$(find components/gfx/src -name '*.cpp')
+RENDER=components/bcd_render/src
+
+g++ -O2 -std=gnu++17 -Itools/host $GFX -Icomponents/bcd_render/include \
+    tools/frame_check.cpp \
+    $RENDER/bcd_dirty_rects.cpp \
+    $RENDER/bcd_glyph_atlas.cpp \
+    $RENDER/bcd_glyph_cache.cpp \
+    $RENDER/bcd_indexed_surface.cpp \
+    $RENDER/bcd_rgb565.cpp \
+    $GFX_SOURCES -o "$BUILD/frame_check"
+
+g++ -O2 -std=gnu++17 -Itools/host $GFX -Icomponents/bcd_render/include \
+    -Icomponents/bcd_assets/include -Isrc \
+    tools/screen_check.cpp src/gameStates.cpp src/board.cpp \
+    $RENDER/bcd_dirty_rects.cpp \
+    $RENDER/bcd_frame_clock.cpp \
+    $RENDER/bcd_glyph_atlas.cpp \
+    $RENDER/bcd_glyph_cache.cpp \
+    $RENDER/bcd_image_cache.cpp \
+    $RENDER/bcd_indexed_surface.cpp \
+    $RENDER/bcd_particles.cpp \
+    $RENDER/bcd_q16.cpp \
+    $RENDER/bcd_quality.cpp \
+    $RENDER/bcd_rgb565.cpp \
+    $RENDER/bcd_screen_cache.cpp \
+    $RENDER/bcd_timeline.cpp \
+    components/bcd_assets/src/bcd_assets.cpp \
+    $GFX_SOURCES -o "$BUILD/screen_check"
+
+python3 tools/asset_compiler.py assets.json "$BUILD/assets.bin"
+
+status=0
+"$BUILD/frame_check" "$@" || status=1
+"$BUILD/screen_check" --assets "$BUILD/assets.bin" "$@" || status=1
+exit $status
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Convert images to the lossless q16 format of the firmware.
+
+    q16.py data/start_screen.png data/start_screen.q16
+    q16.py --check data/start_screen.q16 data/start_screen.png
+
+q16 is QOI adapted to RGB565, the format is documented in
+components/bcd_render/include/bcd_q16.hpp. Reading images needs Pillow.
+--check decodes a q16 file and compares it with the source image, so
+encoder and firmware decoder can be kept in step.
+"""
+
+import argparse
+import struct
+import sys
+
+import asset_compiler
+
+MAGIC = b"Q16I"
+HEADER = struct.Struct("<4sHH")
+OP_RGB = 0xFE
+MAX_RUN = 62
+
+
+def split(v):
+    return v >> 11, (v >> 5) & 0x3F, v & 0x1F
+
+
+def pack(r, g, b):
+    return ((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F)
+
+
+def hash_px(v):
+    r, g, b = split(v)
+    return (r * 3 + g * 5 + b * 7) % 64
+
+
+def wrap(d, bits):
+    """Signed difference modulo 2^bits."""
+    half = 1 << (bits - 1)
+    return ((d + half) & ((1 << bits) - 1)) - half
+
+
+def encode(width, height, pixels):
+    """pixels: RGB565 values, high byte first like the framebuffer."""
+    values = struct.unpack(">%dH" % (width * height), pixels)
+    out = bytearray(HEADER.pack(MAGIC, width, height))
+    index = [0] * 64
+    prev = 0
+    run = 0
+    for i, v in enumerate(values):
+        if v == prev:
+            run += 1
+            if run == MAX_RUN or i == len(values) - 1:
+                out.append(0xC0 | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(0xC0 | (run - 1))
+            run = 0
+        h = hash_px(v)
+        if index[h] == v:
+            out.append(h)
+        else:
+            index[h] = v
+            r, g, b = split(v)
+            pr, pg, pb = split(prev)
+            dr, dg, db = wrap(r - pr, 5), wrap(g - pg, 6), wrap(b - pb, 5)
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2))
+            elif -8 <= dr - dg <= 7 and -8 <= db - dg <= 7:
+                out.append(0x80 | (dg + 32))
+                out.append((dr - dg + 8) << 4 | (db - dg + 8))
+            else:
+                out += bytes((OP_RGB, v >> 8, v & 0xFF))
+        prev = v
+    return bytes(out)
+
+
+def decode(data):
+    """Returns (width, height, RGB565 bytes high byte first)."""
+    magic, width, height = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError("not a q16 image")
+    index = [0] * 64
+    px = 0
+    out = []
+    pos = HEADER.size
+    while len(out) < width * height:
+        op = data[pos]
+        pos += 1
+        if op >> 6 == 0:
+            px = index[op]
+        elif op >> 6 == 1:
+            r, g, b = split(px)
+            px = pack(r + (op >> 4 & 3) - 2, g + (op >> 2 & 3) - 2,
+                      b + (op & 3) - 2)
+        elif op >> 6 == 2:
+            rb = data[pos]
+            pos += 1
+            dg = (op & 0x3F) - 32
+            r, g, b = split(px)
+            px = pack(r + dg + (rb >> 4) - 8, g + dg,
+                      b + dg + (rb & 0x0F) - 8)
+        elif op == OP_RGB:
+            px = data[pos] << 8 | data[pos + 1]
+            pos += 2
+        elif op == 0xFF:
+            raise ValueError("invalid op at %d" % (pos - 1))
+        else:
+            out += [px] * (op & 0x3F)
+        index[hash_px(px)] = px
+        out.append(px)
+    return width, height, struct.pack(">%dH" % len(out), *out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="Compare a q16 file with its source image")
+    parser.add_argument("input")
+    parser.add_argument("output", help="q16 file, or the source image with "
+                        "--check")
+    args = parser.parse_args()
+
+    if args.check:
+        with open(args.input, "rb") as f:
+            width, height, pixels = decode(f.read())
+        w, h, rgb = asset_compiler.load_image(args.output)
+        if (w, h) != (width, height) or \
+                asset_compiler.rgb888_to_rgb565(rgb) != pixels:
+            print("%s does not match %s" % (args.input, args.output))
+            return 1
+        print("%s: %dx%d, identical" % (args.input, width, height))
+        return 0
+
+    width, height, rgb = asset_compiler.load_image(args.input)
+    pixels = asset_compiler.rgb888_to_rgb565(rgb)
+    data = encode(width, height, pixels)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("%s: %dx%d, %d bytes (%.1f%% of RGB565)" % (
+          args.output, width, height, len(data),
+          100.0 * len(data) / len(pixels)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
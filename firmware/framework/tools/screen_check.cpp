@@ -0,0 +1,364 @@
+/**
+ * @file    screen_check.cpp
+ * @brief   Host regression check of the game screens
+ * @version 0.1
+ * @date    18.10.2026
+ *
+ * @copyright Copyright (c) 2026, released under MIT license
+ *
+ * Runs the game's own screens from src/gameStates.cpp on the emulated
+ * ST7735 of tools/host/emulated_panel.hpp and checks what they draw. The
+ * controller plays a script: the start screen starts a game, the game is
+ * paused and resumed and then played until it is lost, the start screen
+ * comes back from the screen cache and exits, and the end screen exits.
+ *
+ * The screens read the controller once per loop iteration, so every
+ * reading is one step of the script. At every step, and when a screen
+ * returns, the check records
+ *
+ *  - a hash of what the panel shows,
+ *  - the primitives the display list rasterised since the last record,
+ *  - the pixels written to the panel since the last record,
+ *
+ * and compares them with tools/host/screen_check.ref. A record that differs
+ * is written as screen_check_<record>.ppm.
+ *
+ * Time is simulated. The frame clock wakes exactly once per frame period
+ * and the tick count follows, so gravity and animations do not depend on
+ * the speed of the host. The pieces come from rand() seeded with
+ * CONFIG_GAME_RANDOM_SEED, which ties the references to the C library they
+ * were made with. The images come from the asset partition built by
+ * tools/asset_compiler.py from assets.json.
+ *
+ * tools/make_references.sh builds this check and tools/frame_check.cpp
+ * against the gfx submodules and runs both. After an intended change,
+ * accept the new frames with
+ *
+ *      tools/make_references.sh --update
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "main.hpp"
+
+static const char *REFERENCES = "tools/host/screen_check.ref";
+static constexpr uint32_t MAX_STEPS = 20000;                                    /**< Steps a screen may take before the check gives up */
+static constexpr size_t MAX_REPORTS = 10;
+
+bcd_system bcd_sys;
+static Main game;
+
+// The simulated clock. The frame timer fires at every multiple of its
+// period, the FreeRTOS tick is 10 ms like on the badge.
+static int64_t now = 1000000;
+static int64_t period = 0;
+
+int64_t esp_timer_get_time() {
+    return now;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args,
+        esp_timer_handle_t *timer) {
+    *timer = (esp_timer_handle_t)&period;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer,
+        uint64_t us) {
+    period = us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    period = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    return ESP_OK;
+}
+
+TickType_t xTaskGetTickCount() {
+    return now / 1000 / portTICK_PERIOD_MS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    now += (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return nullptr;
+}
+
+// Waiting for the frame timer takes until its next expiry
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    if(period != 0) {
+        now = (now / period + 1) * period;
+    }
+    return 1;
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {}
+
+// The asset partition, read from a file
+static std::vector<uint8_t> assetImage;
+static esp_partition_t assetPartition;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+        esp_partition_subtype_t subtype, const char *label) {
+    return assetImage.empty() ? nullptr : &assetPartition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition,
+        size_t offset, void *destination, size_t size) {
+    if(offset + size > assetImage.size()) {
+        return ESP_FAIL;
+    }
+    memcpy(destination, assetImage.data() + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition,
+        size_t offset, size_t size, esp_partition_mmap_memory_t memory,
+        const void **pointer, esp_partition_mmap_handle_t *handle) {
+    if(offset + size > assetImage.size()) {
+        return ESP_FAIL;
+    }
+    *pointer = assetImage.data() + offset;
+    *handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) {}
+
+static bool loadAssets(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if(f == nullptr) {
+        return false;
+    }
+    uint8_t buffer[4096];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        assetImage.insert(assetImage.end(), buffer, buffer + n);
+    }
+    fclose(f);
+    assetPartition.size = assetImage.size();
+    assetPartition.label = CONFIG_ASSETS_PARTITION_LABEL;
+    return !assetImage.empty();
+}
+
+/**
+ * @brief What the controller does while one screen runs
+ *
+ * One character per step: '.' for no button, or the button held, U D L R
+ * for the directions and A B X Y. After the steps, the steps of repeat
+ * are played over and over until the screen returns, which has to be with
+ * the state next.
+ */
+struct screen_script {
+    const char *name;
+    Main::GameState (Main::*run)();
+    const char *steps;
+    const char *repeat;
+    Main::GameState next;
+};
+
+static const screen_script SCRIPT[] = {
+    // Down to Exit and back up, then start
+    { "start", &Main::runStartScreen, "..D.U.B", ".",
+        Main::GameState::Running },
+    // Move and rotate the first piece, let it fall a bit and pause
+    { "game", &Main::runGameScreen, "..L.L.B..R.........DDDD......Y", ".",
+        Main::GameState::Paused },
+    // The box opens, then any button resumes
+    { "pause", &Main::runPauseScreen, "...............B", ".",
+        Main::GameState::Running },
+    // Pieces placed to clear six lines, two of them at once, then the
+    // rest is dropped where it comes until the stack is full
+    { "game", &Main::runGameScreen,
+        "B.B.B.LLLLL.U...B.B.L.U...RRRRR.U...B.B.B.RR.U...LLLLL.U...."
+        "U...RR.U...LLLLL.U...LL.U...B.B.B..U...B.LLLLL.U...L.U...B.LL.U..."
+        "B.RRR.U...B.LLL.U....U...RRR.U...B.RRR.U...B.B.RR.U...", "U..",
+        Main::GameState::Lost },
+    { "lost", &Main::runLostScreen, "...B", ".", Main::GameState::Start },
+    // The start screen again, from the screen cache, and exit
+    { "start", &Main::runStartScreen, ".D.B", ".", Main::GameState::Exit },
+    { "end", &Main::runEndScreen, "..D.A", ".", Main::GameState::Exit },
+};
+
+static uint16_t buttonsOf(char step) {
+    switch(step) {
+        case 'U':
+            return BUTTON_UP;
+        case 'D':
+            return BUTTON_DOWN;
+        case 'L':
+            return BUTTON_LEFT;
+        case 'R':
+            return BUTTON_RIGHT;
+        case 'A':
+            return BUTTON_A;
+        case 'B':
+            return BUTTON_B;
+        case 'X':
+            return BUTTON_X;
+        case 'Y':
+            return BUTTON_Y;
+        default:
+            return 0;
+    }
+}
+
+// The record being made
+static const screen_script *screen = nullptr;
+static uint32_t step = 0;
+static uint32_t primitivesBefore = 0;
+static uint32_t writesBefore = 0;
+
+// Every record, and the references they are compared with
+static std::vector<std::string> records;
+static std::vector<std::string> references;
+static bool compare = true;
+static size_t differences = 0;
+
+static void record(const char *label) {
+    static uint8_t shownPixels[FRAME_SIZE];
+    lcd_type &panel = bcd_sys.getDisplay();
+    frame_type shown(panel.dimensions(), shownPixels);
+    panel.shown(shown);
+
+    const uint32_t primitives = game.renderStatistics().primitives;
+    const uint32_t writes = panel.writes();
+    char line[160];
+    snprintf(line, sizeof(line), "%s %s: %08x, %u primitives, %u px",
+        screen->name, label, (unsigned)hash(shownPixels, FRAME_SIZE),
+        (unsigned)(primitives - primitivesBefore),
+        (unsigned)(writes - writesBefore));
+    primitivesBefore = primitives;
+    writesBefore = writes;
+
+    const size_t index = records.size();
+    records.push_back(line);
+    if(!compare) {
+        return;
+    }
+    const std::string expected = index < references.size()
+        ? references[index] : std::string();
+    if(expected == line) {
+        return;
+    }
+    if(differences++ < MAX_REPORTS) {
+        printf("expected %s\n     got %s\n", expected.c_str(), line);
+        char ppm[64];
+        snprintf(ppm, sizeof(ppm), "screen_check_%u.ppm", (unsigned)index);
+        writePpm(ppm, shown);
+    }
+}
+
+void controllerDriver::capture() {
+    char label[16];
+    snprintf(label, sizeof(label), "%u", (unsigned)step);
+    record(label);
+    if(step == MAX_STEPS) {
+        printf("%s: still running after %u steps\n", screen->name,
+            (unsigned)MAX_STEPS);
+        exit(1);
+    }
+    const size_t steps = strlen(screen->steps);
+    buttons = buttonsOf(step < steps ? screen->steps[step]
+        : screen->repeat[(step - steps) % strlen(screen->repeat)]);
+    step++;
+}
+
+static bool readReferences(const char *path) {
+    FILE *f = fopen(path, "r");
+    if(f == nullptr) {
+        return false;
+    }
+    char line[160];
+    while(fgets(line, sizeof(line), f) != nullptr) {
+        line[strcspn(line, "\n")] = '\0';
+        references.push_back(line);
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool update = false;
+    const char *assets = nullptr;
+    const char *path = REFERENCES;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if(strcmp(argv[i], "--assets") == 0 && i + 1 < argc) {
+            assets = argv[++i];
+        } else {
+            path = argv[i];
+        }
+    }
+    if(assets == nullptr || !loadAssets(assets)) {
+        printf("Cannot read the asset partition, pass the output of "
+            "tools/asset_compiler.py with --assets\n");
+        return 1;
+    }
+    compare = !update;
+    if(compare && !readReferences(path)) {
+        printf("Cannot read %s, make it with tools/make_references.sh "
+            "--update\n", path);
+        return 1;
+    }
+
+    srand(CONFIG_GAME_RANDOM_SEED);
+    game.prepareScreens();
+
+    bool ok = true;
+    for(const screen_script &s : SCRIPT) {
+        screen = &s;
+        step = 0;
+        const Main::GameState next = (game.*s.run)();
+        record("returns");
+        if(next != s.next) {
+            printf("%s: returns state %d after %u steps, expected %d\n",
+                s.name, (int)next, (unsigned)step, (int)s.next);
+            ok = false;
+            break;
+        }
+    }
+
+    lcd_type &panel = bcd_sys.getDisplay();
+    if(!panel.ready()) {
+        printf("panel left in another mode\n");
+        ok = false;
+    }
+    if(panel.faults() != 0) {
+        printf("%u panel faults\n", panel.faults());
+        ok = false;
+    }
+
+    if(update) {
+        FILE *f = fopen(path, "w");
+        if(f == nullptr) {
+            printf("Cannot write %s\n", path);
+            return 1;
+        }
+        for(const std::string &line : records) {
+            fprintf(f, "%s\n", line.c_str());
+        }
+        fclose(f);
+        printf("%s updated, %u records\n", path, (unsigned)records.size());
+        return ok ? 0 : 1;
+    }
+
+    if(records.size() != references.size()) {
+        printf("%u records, %u references\n", (unsigned)records.size(),
+            (unsigned)references.size());
+        ok = false;
+    }
+    ok = ok && differences == 0;
+    printf(ok ? "All screens match\n" : "Screens differ\n");
+    return ok ? 0 : 1;
+}
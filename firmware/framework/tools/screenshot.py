@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Decode framebuffer captures of the screenshot console command into PNGs.
+
+Either talk to the badge directly:
+
+    screenshot.py --port /dev/ttyUSB0 frame.png
+
+or decode a log of the console output (eg. from pio device monitor):
+
+    screenshot.py --input console.log frame.png
+
+A log can contain several captures. They are written as frame.png,
+frame_1.png, ... in the order they appear. Only the standard library is
+needed, except for pyserial when --port is used.
+
+The frame layout is documented in commands/cmd_screenshot.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"BCDS"
+HEADER = struct.Struct("<4sBBHHI")
+RAW = 0
+RLE = 1
+
+
+class FrameError(Exception):
+    pass
+
+
+def decode_rle(payload, count):
+    out = bytearray()
+    i = 0
+    while i < len(payload):
+        c = payload[i]
+        i += 1
+        if c & 0x80:
+            out += payload[i:i + 2] * ((c & 0x7F) + 1)
+            i += 2
+        else:
+            out += payload[i:i + 2 * (c + 1)]
+            i += 2 * (c + 1)
+    if len(out) != 2 * count:
+        raise FrameError("RLE payload decodes to %d pixels, expected %d"
+                         % (len(out) // 2, count))
+    return bytes(out)
+
+
+def parse_frame(data, offset):
+    """Returns (width, height, rgb565 bytes, end offset) of the frame at
+    offset."""
+    if len(data) < offset + HEADER.size:
+        raise FrameError("Truncated header")
+    magic, version, encoding, width, height, length = \
+        HEADER.unpack_from(data, offset)
+    if version != 1:
+        raise FrameError("Unknown version %d" % version)
+    end = offset + HEADER.size + length
+    if len(data) < end + 4:
+        raise FrameError("Truncated payload")
+    crc, = struct.unpack_from("<I", data, end)
+    if zlib.crc32(data[offset:end]) != crc:
+        raise FrameError("CRC mismatch")
+
+    payload = data[offset + HEADER.size:end]
+    if encoding == RAW:
+        pixels = payload
+    elif encoding == RLE:
+        pixels = decode_rle(payload, width * height)
+    else:
+        raise FrameError("Unknown encoding %d" % encoding)
+    return width, height, pixels, end + 4
+
+
+def find_frames(data):
+    frames = []
+    offset = data.find(MAGIC)
+    while offset >= 0:
+        try:
+            width, height, pixels, end = parse_frame(data, offset)
+            frames.append((width, height, pixels))
+            offset = data.find(MAGIC, end)
+        except FrameError as e:
+            print("Skipping frame at %d: %s" % (offset, e), file=sys.stderr)
+            offset = data.find(MAGIC, offset + 1)
+    return frames
+
+
+def rgb565_to_rgb888(pixels):
+    out = bytearray(len(pixels) // 2 * 3)
+    for i in range(0, len(pixels) // 2):
+        v = (pixels[2 * i] << 8) | pixels[2 * i + 1]
+        r = (v >> 11) & 0x1F
+        g = (v >> 5) & 0x3F
+        b = v & 0x1F
+        out[3 * i] = (r << 3) | (r >> 2)
+        out[3 * i + 1] = (g << 2) | (g >> 4)
+        out[3 * i + 2] = (b << 3) | (b >> 2)
+    return bytes(out)
+
+
+def write_png(path, width, height, rgb):
+    def chunk(kind, body):
+        return (struct.pack(">I", len(body)) + kind + body
+                + struct.pack(">I", zlib.crc32(kind + body)))
+
+    stride = width * 3
+    raw = b"".join(b"\x00" + rgb[y * stride:(y + 1) * stride]
+                   for y in range(height))
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2,
+                                           0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def capture(port, baud, encoding, timeout):
+    import serial
+
+    with serial.Serial(port, baud, timeout=0.1) as s:
+        s.reset_input_buffer()
+        s.write(("screenshot %s\n" % encoding).encode())
+        data = bytearray()
+        start = time.monotonic()
+        while time.monotonic() - start < timeout:
+            data += s.read(4096)
+            if find_frames(bytes(data)):
+                break
+        print("Received %d bytes in %.2f s" % (len(data),
+              time.monotonic() - start), file=sys.stderr)
+        return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="Serial port of the badge")
+    source.add_argument("--input", help="Captured console output")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--raw", action="store_true",
+                        help="Ask for an uncompressed capture")
+    parser.add_argument("--timeout", type=float, default=10.0)
+    parser.add_argument("output", help="PNG file to write")
+    args = parser.parse_args()
+
+    if args.port:
+        data = capture(args.port, args.baud, "raw" if args.raw else "rle",
+                       args.timeout)
+    else:
+        with open(args.input, "rb") as f:
+            data = f.read()
+
+    frames = find_frames(data)
+    if not frames:
+        print("No screenshot found", file=sys.stderr)
+        return 1
+
+    base, ext = os.path.splitext(args.output)
+    for n, (width, height, pixels) in enumerate(frames):
+        path = args.output if n == 0 else "%s_%d%s" % (base, n, ext)
+        write_png(path, width, height, rgb565_to_rgb888(pixels))
+        print("%s: %dx%d" % (path, width, height))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())